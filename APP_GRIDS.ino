@@ -0,0 +1,208 @@
+// Copyright (c) 2018, Marc Nostromo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Full three-voice Grids: needs all four outputs, so it's an app rather than
+// an applet.
+//
+// TR1: Clock, TR2: Reset
+// CV1: X, CV2: Y, CV3: Chaos, CV4: Density (all parts)
+// A: BD, B: SD, C: HH, D: Accent
+
+#include "HSApplication.h"
+#include "grids.h"
+
+#define GRIDS_POSITION_HYSTERESIS 2
+
+enum GridsSetting {
+    GRIDS_SETTING_X,
+    GRIDS_SETTING_Y,
+    GRIDS_SETTING_DENSITY_BD,
+    GRIDS_SETTING_DENSITY_SD,
+    GRIDS_SETTING_DENSITY_HH,
+    GRIDS_SETTING_CHAOS,
+    GRIDS_SETTING_LAST
+};
+
+class GridsKit : public HSApplication,
+    public settings::SettingsBase<GridsKit, GRIDS_SETTING_LAST> {
+public:
+    void Start() {
+        cursor = 0;
+        kit.reset();
+        seeded = false;
+        position_cv[0] = position_cv[1] = 0;
+    }
+
+    // Map rebuilds are too heavy for the ISR, so they're done here
+    void Loop() {
+        kit.update();
+    }
+
+    void Resume() {
+    }
+
+    void Controller() {
+        if (Clock(1)) kit.reset();
+
+        kit.setPosition(PositionValue(GRIDS_SETTING_X, 0), PositionValue(GRIDS_SETTING_Y, 1));
+
+        if (Clock(0)) {
+            // Startup is too deterministic to seed from, the first clock isn't
+            if (!seeded) {
+                kit.seed(ARM_DWT_CYCCNT);
+                seeded = true;
+            }
+
+            const int density_cv = Proportion(DetentedIn(3), HSAPPLICATION_5V, 255);
+            uint8_t density[grids::kNumParts];
+            for (uint8_t part = 0; part < grids::kNumParts; part++)
+            {
+                density[part] = constrain(values_[GRIDS_SETTING_DENSITY_BD + part] + density_cv, 0, 255);
+            }
+
+            const uint8_t state = kit.process(density, ModulatedValue(GRIDS_SETTING_CHAOS, 2));
+
+            for (uint8_t ch = 0; ch < grids::Kit::OUTPUT_COUNT; ch++)
+            {
+                if (state & (1 << ch)) ClockOut(ch);
+            }
+        }
+    }
+
+    void View() {
+        gfxHeader("Grids");
+
+        const char *labels[] = {"X", "Y", "BD", "SD", "HH", "Chaos"};
+        for (int s = 0; s < GRIDS_SETTING_LAST; s++)
+        {
+            int y = 15 + 8 * s;
+            gfxPrint(1, y, labels[s]);
+            gfxPrint(40 + pad(100, values_[s]), y, values_[s]);
+            if (s == cursor) gfxCursor(40, y + 7, 19);
+        }
+
+        // Outputs
+        const char *outputs[] = {"BD", "SD", "HH", "Ac"};
+        for (int ch = 0; ch < grids::Kit::OUTPUT_COUNT; ch++)
+        {
+            int x = 72 + 14 * ch;
+            gfxPrint(x, 15, outputs[ch]);
+            if (ViewOut(ch) > 0) gfxRect(x, 25, 11, 11);
+            else gfxFrame(x, 25, 11, 11);
+        }
+
+        // Pattern position
+        gfxFrame(72, 42, 53, 5);
+        gfxRect(72 + kit.step() * 53 / grids::kStepsPerPattern, 42, 2, 5);
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // Control handlers
+    /////////////////////////////////////////////////////////////////
+    void OnLeftEncoderMove(int direction) {
+        cursor = constrain(cursor + direction, 0, GRIDS_SETTING_LAST - 1);
+        ResetCursor();
+    }
+
+    void OnRightEncoderMove(int direction) {
+        change_value(cursor, direction);
+        ResetCursor();
+    }
+
+private:
+    int cursor;
+    grids::Kit kit;
+    bool seeded; // Chaos is seeded from the time of the first clock
+    int position_cv[2]; // CV contribution to X and Y, after hysteresis
+
+    uint8_t ModulatedValue(GridsSetting setting, int ch) {
+        return constrain(values_[setting] + Proportion(DetentedIn(ch), HSAPPLICATION_5V, 255), 0, 255);
+    }
+
+    // X and Y only follow the CV once it has moved by more than the hysteresis,
+    // so ADC noise doesn't keep the map rebuilding
+    uint8_t PositionValue(GridsSetting setting, int ch) {
+        const int cv = Proportion(DetentedIn(ch), HSAPPLICATION_5V, 255);
+        if (abs(cv - position_cv[ch]) > GRIDS_POSITION_HYSTERESIS) position_cv[ch] = cv;
+        return constrain(values_[setting] + position_cv[ch], 0, 255);
+    }
+};
+
+SETTINGS_DECLARE(GridsKit, GRIDS_SETTING_LAST) {
+    {128, 0, 255, "X", NULL, settings::STORAGE_TYPE_U8},
+    {128, 0, 255, "Y", NULL, settings::STORAGE_TYPE_U8},
+    {128, 0, 255, "BD density", NULL, settings::STORAGE_TYPE_U8},
+    {128, 0, 255, "SD density", NULL, settings::STORAGE_TYPE_U8},
+    {128, 0, 255, "HH density", NULL, settings::STORAGE_TYPE_U8},
+    {0, 0, 255, "Chaos", NULL, settings::STORAGE_TYPE_U8},
+};
+
+GridsKit GridsKit_instance;
+
+// App stubs
+void GridsKit_init() {
+    GridsKit_instance.InitDefaults();
+    GridsKit_instance.BaseStart();
+}
+
+size_t GridsKit_storageSize() {
+    return GridsKit::storageSize();
+}
+
+size_t GridsKit_save(void *storage) {
+    return GridsKit_instance.Save(storage);
+}
+
+size_t GridsKit_restore(const void *storage) {
+    size_t s = GridsKit_instance.Restore(storage);
+    GridsKit_instance.Resume();
+    return s;
+}
+
+void FASTRUN GridsKit_isr() {
+    return GridsKit_instance.BaseController();
+}
+
+void GridsKit_handleAppEvent(OC::AppEvent event) {
+    if (event == OC::APP_EVENT_RESUME) {
+        GridsKit_instance.Resume();
+    }
+}
+
+void GridsKit_loop() {
+    GridsKit_instance.Loop();
+}
+
+void GridsKit_menu() {
+    GridsKit_instance.BaseView();
+}
+
+void GridsKit_screensaver() {} // Deprecated
+
+void GridsKit_handleButtonEvent(const UI::Event &event) {
+}
+
+void GridsKit_handleEncoderEvent(const UI::Event &event) {
+    // Left encoder turned
+    if (event.control == OC::CONTROL_ENCODER_L) GridsKit_instance.OnLeftEncoderMove(event.value);
+
+    // Right encoder turned
+    if (event.control == OC::CONTROL_ENCODER_R) GridsKit_instance.OnRightEncoderMove(event.value);
+}
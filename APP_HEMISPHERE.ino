@@ -30,6 +30,7 @@ namespace menu = OC::menu;
 #include "HSicons.h"
 #include "HSMIDI.h"
 #include "HSClockManager.h"
+#include "HSInputConditioner.h"
 
 #define DECLARE_APPLET(id, categories, class_name) \
 { id, categories, class_name ## _Start, class_name ## _Controller, class_name ## _View, \
@@ -135,6 +136,9 @@ public:
         // Turn off clock forwarding if Metronome is running
         if (clock_m->IsRunning()) forwarding = 0;
 
+        // Condition all four CV inputs once, for both hemispheres
+        input_c->Process();
+
         for (int h = 0; h < 2; h++)
         {
             int index = my_applet[h];
@@ -310,6 +314,7 @@ private:
     uint32_t click_tick; // Measure time between clicks for double-click
     int first_click; // The first button pushed of a double-click set, to see if the same one is pressed
     ClockManager *clock_m = clock_m->get();
+    InputConditioner *input_c = input_c->get();
 
     void DrawFilterSelector(int h) {
         int offset = h * 64;
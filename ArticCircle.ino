@@ -79,6 +79,8 @@ void FASTRUN CORE_timer_ISR() {
   // 100us: 10kHz / 4 / 4 ~ .6kHz
   // 60us: 16.666K / 4 / 4 ~ 1kHz
   // kAdcSmoothing == 4 has some (maybe 1-2LSB) jitter but seems "Good Enough".
+  // With OC_ADC_ENABLE_DMA, conversions run continuously in the background and
+  // this only picks up the decimated values of all 4 channels.
   OC::ADC::Scan();
 
   // Pin changes are tracked in separate ISRs, so depending on prio it might
@@ -182,6 +184,7 @@ void FASTRUN loop() {
 
     // Run current app
     OC::apps::current_app->loop();
+    OC::apps::CompactStorage();
 
     // UI events
     OC::UiMode mode = OC::ui.DispatchEvents(OC::apps::current_app);
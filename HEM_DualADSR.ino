@@ -0,0 +1,273 @@
+// Copyright (c) 2018, Marc Nostromo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "src/nostromo.h"
+
+// Two ADSR envelopes sharing their settings: TR1 and TR2 are the gates of A
+// and B, CV1 and CV2 modulate the stage chosen by "cv" on each, an octave
+// of time per volt (or the sustain level). Outputs are 0-5V.
+
+namespace NDualADSR
+{
+  struct Model
+  {
+    enum class Curves
+    {
+      Linear,
+      Exponential,
+      Quartic,
+      Sine,
+      Plateau,
+      Dipper,
+      COUNT
+    };
+
+    enum class Triggerings
+    {
+      Retrigger,
+      Legato,
+      COUNT
+    };
+
+    enum class Targets
+    {
+      Attack,
+      Decay,
+      Sustain,
+      Release,
+      All,
+      COUNT
+    };
+
+    struct Time: Property<float>
+    {
+      Time(float value)
+      {
+        setValue(value);
+        setRange(0.001f, 10.f, 0.005f);
+        setExponentialScaling(3.f);
+      }
+
+      using ValueConverter = ExponentialValueConverter;
+      using StringConverter = ShortTimeStringConverter;
+    };
+
+    struct Attack: Time
+    {
+      Attack()
+      : Time(0.01f)
+      {
+        setLabel("a");
+      }
+    };
+
+    struct Decay: Time
+    {
+      Decay()
+      : Time(0.2f)
+      {
+        setLabel("d");
+      }
+    };
+
+    struct Sustain: PercentageProperty
+    {
+      Sustain()
+      {
+        setValue(0.5f);
+        setLabel("s");
+      }
+    };
+
+    struct Release: Time
+    {
+      Release()
+      : Time(0.5f)
+      {
+        setLabel("r");
+      }
+    };
+
+    struct Curve: Property<Curves>
+    {
+      Curve()
+      {
+        setValue(Curves::Exponential);
+        setEnumStrings({"Lin", "Exp", "Qrt", "Sin", "Plt", "Dip"});
+      }
+    };
+
+    struct Triggering: Property<Triggerings>
+    {
+      Triggering()
+      {
+        setValue(Triggerings::Retrigger);
+        setEnumStrings({"Rtg", "Leg"});
+      }
+    };
+
+    struct Target: Property<Targets>
+    {
+      Target()
+      {
+        setValue(Targets::All);
+        setEnumStrings({"cvA", "cvD", "cvS", "cvR", "cv*"});
+      }
+    };
+
+    using Properties = PropertySet<Attack, Decay, Sustain, Release, Curve, Triggering, Target>;
+  };
+
+  class Applet : public ArticCircleApplet<Model> {
+  public:
+    using Stage = ADSREnvelope::Stage;
+
+    Applet()
+    {
+      // Maximum 9 characters
+      //       123456789
+      setName("Dual ADSR");
+
+      for (auto& envelope: envelopes_)
+      {
+        envelope.init();
+      }
+
+      // The bars of the two levels are on the right of the times
+      setPosition<Model::Curve>(0, 36);
+      setPosition<Model::Triggering>(22, 36);
+      setPosition<Model::Target>(44, 36);
+
+      setCallback<Model::Attack>([this](const float& time) {
+        setTime(Stage::Attack, time);
+      });
+
+      setCallback<Model::Decay>([this](const float& time) {
+        setTime(Stage::Decay, time);
+      });
+
+      // Ramped in the ISR, the level is directly on the outputs
+      setCallback<Model::Sustain>([this](const float& level) {
+        sustain_.set(sample_t(level));
+      });
+
+      setCallback<Model::Release>([this](const float& time) {
+        setTime(Stage::Release, time);
+      });
+
+      setCallback<Model::Curve>([this](const Model::Curves& curve) {
+        // Attack, then decay and release
+        const peaks::EnvelopeShape shapes[][2] = {
+          {peaks::ENV_SHAPE_LINEAR, peaks::ENV_SHAPE_LINEAR},
+          {peaks::ENV_SHAPE_QUARTIC, peaks::ENV_SHAPE_EXPONENTIAL},
+          {peaks::ENV_SHAPE_QUARTIC, peaks::ENV_SHAPE_QUARTIC},
+          {peaks::ENV_SHAPE_SINE, peaks::ENV_SHAPE_SINE},
+          {peaks::ENV_SHAPE_PLATEAU, peaks::ENV_SHAPE_PLATEAU},
+          {peaks::ENV_SHAPE_MEDIUM_DIPPER, peaks::ENV_SHAPE_MEDIUM_DIPPER},
+        };
+        for (auto& envelope: envelopes_)
+        {
+          envelope.setShape(Stage::Attack, shapes[int(curve)][0]);
+          envelope.setShape(Stage::Decay, shapes[int(curve)][1]);
+          envelope.setShape(Stage::Release, shapes[int(curve)][1]);
+        }
+      });
+
+      setCallback<Model::Triggering>([this](const Model::Triggerings& triggering) {
+        for (auto& envelope: envelopes_)
+        {
+          envelope.setTriggering(triggering == Model::Triggerings::Legato
+            ? ADSREnvelope::Triggering::Legato
+            : ADSREnvelope::Triggering::Retrigger);
+        }
+      });
+
+      bind<Model::Target>(target_);
+    }
+
+    virtual void reset() final
+    {
+      sustain_.reset();
+    }
+
+    virtual void tick() final
+    {
+      const auto sustain = sustain_.tick();
+      ForEachChannel(ch)
+      {
+        auto& envelope = envelopes_[ch];
+        modulate(envelope, In(ch), sustain);
+        Out(ch, toCV(envelope.tick(Gate(ch)), HEMISPHERE_MAX_CV));
+      }
+    }
+
+    void drawApplet() final
+    {
+      ArticCircleApplet<NDualADSR::Model>::drawApplet();
+
+      ForEachChannel(ch)
+      {
+        const int x = 50 + ch * 7;
+        const int height = (envelopes_[ch].value().value_ >> (sample_t::shift_ - 8)) * 32 >> 8;
+        gfxFrame(x, 15, 5, 34);
+        gfxRect(x + 1, 48 - height, 3, height);
+      }
+    }
+
+  private:
+    void setTime(const Stage stage, const float seconds)
+    {
+      const int time = secondsToTimeUnits(seconds, kSampleRate);
+      for (auto& envelope: envelopes_)
+      {
+        envelope.setTime(stage, time);
+      }
+    }
+
+    // A volt is an octave of time, as kTimeUnitsPerOctave is a volt of CV
+    void modulate(ADSREnvelope& envelope, const int cv, const sample_t& sustain)
+    {
+      const bool all = (target_ == Model::Targets::All);
+      envelope.setModulation(Stage::Attack, (all || target_ == Model::Targets::Attack) ? cv : 0);
+      envelope.setModulation(Stage::Decay, (all || target_ == Model::Targets::Decay) ? cv : 0);
+      envelope.setModulation(Stage::Release, (all || target_ == Model::Targets::Release) ? cv : 0);
+
+      const int sustainCV = (target_ == Model::Targets::Sustain) ? cv : 0;
+      envelope.setSustain(sustain + sample_t::fromValue(sustainCV * ((1 << sample_t::shift_) / HEMISPHERE_MAX_CV)));
+    }
+
+    Model::Targets target_ = Model::Targets::All;
+    DezipperedValue<sample_t> sustain_;
+    ADSREnvelope envelopes_[2];
+  };
+
+  Applet instance_[2];
+
+} // NDualADSR
+
+void DualADSR_Start(bool hemisphere) {NDualADSR::instance_[hemisphere].BaseStart(hemisphere);}
+void DualADSR_Controller(bool hemisphere, bool forwarding) {NDualADSR::instance_[hemisphere].BaseController(forwarding);}
+void DualADSR_View(bool hemisphere) {NDualADSR::instance_[hemisphere].BaseView();}
+void DualADSR_OnButtonPress(bool hemisphere) {NDualADSR::instance_[hemisphere].OnButtonPress();}
+void DualADSR_OnEncoderMove(bool hemisphere, int direction) {NDualADSR::instance_[hemisphere].OnEncoderMove(direction);}
+void DualADSR_ToggleHelpScreen(bool hemisphere) {NDualADSR::instance_[hemisphere].HelpScreen();}
+uint32_t DualADSR_OnDataRequest(bool hemisphere) {return NDualADSR::instance_[hemisphere].OnDataRequest();}
+void DualADSR_OnDataReceive(bool hemisphere, uint32_t data) {NDualADSR::instance_[hemisphere].OnDataReceive(data);}
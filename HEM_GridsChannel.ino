@@ -108,20 +108,24 @@ namespace NGridsChannel
 
   namespace detail
   {
+    enum
+    {
+      kMap,
+      kAltMap,
+      kMapCount
+    };
+
     // This one uses standard grids value
-    uint8_t calcStandardLevel(grids::Channel& channel, const grids::Channel::Selector selector, const uint8_t x ,const uint8_t y)
+    uint8_t calcStandardLevel(const grids::BufferedMap* maps, const grids::Selector selector, const uint8_t step)
     {
-      return channel.level(selector, x, y);
+      return maps[kMap].front().level(selector, step);
     }
 
     // this one returns the difference between two points located at different place on the map
-    uint8_t calcAlternateLevel(grids::Channel& channel, const grids::Channel::Selector selector, const uint8_t x ,const uint8_t y)
+    uint8_t calcAlternateLevel(const grids::BufferedMap* maps, const grids::Selector selector, const uint8_t step)
     {
-      const auto level1 = channel.level(selector, x, y);
-
-      const auto altX = (x + 128) % 256;
-      const auto altY =  (y + 128) % 256;
-      const auto level2 = channel.level(selector, altX, altY);
+      const auto level1 = maps[kMap].front().level(selector, step);
+      const auto level2 = maps[kAltMap].front().level(selector, step);
       return (level2 > level1) ? (level2 - level1) : (level1 - level2);
     }
   }
@@ -176,7 +180,7 @@ namespace NGridsChannel
             const auto density =  constrain(density_[ch] + Proportion(DetentedIn(0), HEMISPHERE_MAX_CV, 256), 0, 256);
             const uint8_t threshold = ~density;
 
-            const auto level =  (processor_[ch]) ? processor_[ch](channel_, selector_[ch], x_, y_) : 0;
+            const auto level =  (processor_[ch]) ? processor_[ch](maps_, selector_[ch], channel_.step()) : 0;
 
             if (density_[ch] == 255) // Output levels
             {
@@ -222,6 +226,13 @@ namespace NGridsChannel
         channel_.reset();
       }
 
+      // Only request the positions, the maps are rebuilt from the view
+      maps_[detail::kMap].setPosition(x_, y_);
+      if (usesAltMap())
+      {
+        maps_[detail::kAltMap].setPosition(uint8_t(x_ + 128), uint8_t(y_ + 128));
+      }
+
       if (Clock(0))
       {
         processStep();
@@ -232,6 +243,14 @@ namespace NGridsChannel
     /* Draw the screen */
     void drawApplet() final
     {
+      // Map rebuilds are too heavy for the ISR, and the view is the
+      // applet's only slot in the main loop
+      maps_[detail::kMap].update();
+      if (usesAltMap())
+      {
+        maps_[detail::kAltMap].update();
+      }
+
       ArticCircleApplet<Model>::drawApplet();
       ForEachChannel(ch)
       {
@@ -290,13 +309,19 @@ namespace NGridsChannel
     uint8_t density_[2];
     grids::Channel::Selector selector_[2];
 
-    using ProcessorFn = std::function<uint8_t(grids::Channel&, const grids::Channel::Selector, const uint8_t,const uint8_t)>;
+    bool usesAltMap() const
+    {
+      return (processor_[0] == detail::calcAlternateLevel) || (!percentageOnRight_ && processor_[1] == detail::calcAlternateLevel);
+    }
+
+    using ProcessorFn = uint8_t (*)(const grids::BufferedMap*, const grids::Selector, const uint8_t);
     ProcessorFn processor_[2];
 
     bool percentageOnRight_;
     bool flipFlopOutput_[2];
     bool flopState_[2];
     grids::Channel channel_;
+    grids::BufferedMap maps_[detail::kMapCount];
 
     TriggerSizer<16, 24> sizer_[2];
   };
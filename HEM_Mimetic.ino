@@ -22,6 +22,8 @@
 
 namespace NMimetic
 {
+  constexpr uint16_t kMaxLength = 32;
+
   template <typename tProperty>
   struct RandomValueGenerator: public detail::IValueConverter
   {
@@ -46,7 +48,43 @@ namespace NMimetic
       }
       using ValueConverter = RandomValueGenerator<Seed>;
     };
-    using Properties = PropertySet<Seed>;
+
+    struct Length: Property<int>
+    {
+      Length()
+      {
+        setRange(1, kMaxLength);
+        setValue(16);
+        setLabel("L");
+      }
+    };
+
+    // Probability of rewriting the current step, as on a Turing Machine
+    struct Mutate: PercentageProperty
+    {
+      Mutate()
+      {
+        setValue(0.f);
+      }
+    };
+
+    enum class LockModes
+    {
+      FREE,
+      LOCKED,
+      COUNT
+    };
+
+    struct Lock: Property<LockModes>
+    {
+      Lock()
+      {
+        setValue(LockModes::FREE);
+        setEnumStrings({"Free", "Lock"});
+      }
+    };
+
+    using Properties = PropertySet<Seed, Length, Mutate, Lock>;
   };
 
 
@@ -58,13 +96,26 @@ namespace NMimetic
       //       123456789
       setName("Mimetic");
 
+      position_ = 0;
+      clockCount_ = 0;
+      reset_ = true;
+
       setCallback<Model::Seed>([this](const auto& seed){
-        this->seed_ = seed;
+        this->setSeed(seed);
       });
 
-      length_ = 16;
-      position_ = 0;
-      reset_ = true;
+      setCallback<Model::Length>([this](const int &length){
+        length_ = length;
+        position_ %= length_;
+      });
+
+      setCallback<Model::Mutate>([this](const float &probability){
+        mutateThreshold_ = uint32_t(probability * 65535.f);
+      });
+
+      setCallback<Model::Lock>([this](const Model::LockModes &mode){
+        locked_ = (mode == Model::LockModes::LOCKED);
+      });
     }
 
     virtual void reset() final
@@ -88,11 +139,12 @@ namespace NMimetic
             Out(0, 1.f * HEMISPHERE_MAX_CV);
         }
         reset_ = false;
-        if (position_ == 0)
+
+        if (!locked_ && (mutations_.at(clockCount_++) >> 16) < mutateThreshold_)
         {
-          rand_.seed(seed_);
+          ++revisions_[position_];
         }
-        const auto value = rand_.tick();
+        const auto value = rand_.at(stepIndex(position_));
         Out(0, float(value) * HEMISPHERE_MAX_CV);
       }
     }
@@ -104,11 +156,30 @@ namespace NMimetic
     }
 
   private:
+    void setSeed(uint32_t seed)
+    {
+      rand_.seed(seed);
+      mutations_.seed(~seed);
+      std::fill(revisions_, revisions_ + kMaxLength, 0);
+    }
+
+    // Each step's value is addressed directly by its position and the number
+    // of times it was rewritten, so reset and length changes don't need to
+    // replay the sequence
+    uint32_t stepIndex(uint16_t step) const
+    {
+      return (uint32_t(revisions_[step]) << 8) | step;
+    }
+
     uint16_t position_;
     uint16_t length_;
-    uint32_t seed_;
+    uint16_t revisions_[kMaxLength];
+    uint32_t clockCount_;
+    uint32_t mutateThreshold_;
+    bool locked_;
     bool reset_;
-    Random<sample_t> rand_;
+    CounterRandom<sample_t> rand_;
+    CounterRandom<uint32_t> mutations_;
   };
 
   Applet instance_[2];
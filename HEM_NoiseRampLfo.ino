@@ -24,35 +24,163 @@ namespace NNoiseRampLfo
 {
   struct Model
   {
-    using Properties = PropertySet<>;
+    enum class Interpolations
+    {
+      Linear,
+      Cubic,
+      Smooth,
+      COUNT
+    };
+
+    struct Rate: Property<float>
+    {
+      Rate()
+      {
+        setValue(0.5f);
+        setRange(0.01f, 20.f, 0.005f);
+        setExponentialScaling(3.f);
+      }
+
+      using ValueConverter = ExponentialValueConverter;
+    };
+
+    struct Interpolation: Property<Interpolations>
+    {
+      Interpolation()
+      {
+        setValue(Interpolations::Linear);
+        setEnumStrings({"Lin", "Cubic", "Smooth"});
+      }
+    };
+
+    using Properties = PropertySet<Rate, Interpolation>;
   };
 
+  // Each segment between two random values is a cubic polynomial of the
+  // segment's phase, whose coefficients are computed when the segment starts.
+  class Segment
+  {
+  public:
+    using Interpolations = Model::Interpolations;
+
+    // Ramp from p1 to p2, p0 and p3 being the previous and next values
+    void start(Interpolations interpolation, const sample_t& p0, const sample_t& p1, const sample_t& p2, const sample_t& p3)
+    {
+      c0_ = p1;
+      switch (interpolation)
+      {
+        case Interpolations::Linear:
+          c1_ = p2 - p1;
+          c2_ = c3_ = sample_t(0);
+          break;
+        case Interpolations::Cubic: // Catmull-Rom
+          c1_ = (p2 - p0) * sample_t(0.5);
+          c2_ = p0 - p1 * sample_t(2.5) + p2 * sample_t(2) - p3 * sample_t(0.5);
+          c3_ = (p3 - p0) * sample_t(0.5) + (p1 - p2) * sample_t(1.5);
+          break;
+        default: // Perlin's fade curve, t * t * (3 - 2 * t)
+          c1_ = sample_t(0);
+          c2_ = (p2 - p1) * sample_t(3);
+          c3_ = (p1 - p2) * sample_t(2);
+          break;
+      }
+    }
+
+    sample_t value(const sample_t& t) const
+    {
+      return ((c3_ * t + c2_) * t + c1_) * t + c0_;
+    }
+
+  private:
+    sample_t c0_;
+    sample_t c1_;
+    sample_t c2_;
+    sample_t c3_;
+  };
 
   class Applet : public ArticCircleApplet<Model> {
   public:
+    static constexpr int kControlRateDivider = 4;
+
     Applet()
     {
       // Maximum 9 characters
       //       123456789
       setName("NzRmpLfo");
-      mPhasor.reset(kSampleRate);
-      mPhasor.setFrequency(mLfoFrequency);
+      // A 20Hz LFO doesn't need every ISR
+      setControlRateDivider(kControlRateDivider);
+      mPhasor.reset(controlRate());
+
+      setCallback<Model::Rate>([this](const float &rate){
+        mRate = rate;
+        updateFrequency();
+      });
+
+      bind<Model::Interpolation>(mInterpolation);
     }
 
-    virtual void reset() final {};
+    virtual void reset() final
+    {
+      mTicksSinceClock = 0;
+      mLastPeriod = 0;
+      mSynced = false;
+      mHolding = false;
+      for (auto& point: mPoints)
+      {
+        point = sample_t(0);
+      }
+      mSegment.start(mInterpolation, mPoints[0], mPoints[1], mPoints[2], mPoints[3]);
+    };
 
     virtual void tick() final
     {
-      mPhasor.tick();
+      if (Changed(0))
+      {
+        updateFrequency();
+      }
+
+      // Clock sync: each clock starts a segment lasting one clock period.
+      // Clock periods are counted in ISRs, so this counts ISRs too
+      mTicksSinceClock += kControlRateDivider;
+      if (Clock(0))
+      {
+        // The first clock after a pause measures the pause, so only follow
+        // the clock once two consecutive periods agree within an octave
+        const int period = ClockCycleTicks(0);
+        mSynced = (mLastPeriod > 0) && (period < 2 * mLastPeriod) && (mLastPeriod < 2 * period);
+        mLastPeriod = period;
+        mTicksSinceClock = 0;
+        if (mSynced)
+        {
+          mClockFrequency = kSampleRate / float(period);
+          updateFrequency();
+        }
+        mPhasor.reset(controlRate());
+        startSegment();
+      }
+      else if (mSynced && mTicksSinceClock > 2 * ClockCycleTicks(0))
+      {
+        // Clock stopped, back to free running
+        mSynced = false;
+        updateFrequency();
+      }
+
+      const auto phase = mPhasor.tick();
       if (mPhasor.flanked())
       {
-        // new target between zero and one
-        const auto target = rand_.tick() * sample_t(2) - sample_t(1);
-        const auto offset = target - mValue;
-        mInc = sample_t(mLfoFrequency / kSampleRate) * offset;
+        if (mSynced)
+        {
+          // Wait for the next clock at the end of the segment
+          mHolding = true;
+        }
+        else
+        {
+          startSegment();
+        }
       }
-      mValue += mInc;
-      Out(0, float(mValue) * HEMISPHERE_3V_CV);
+
+      const auto value = mHolding ? mPoints[2] : mSegment.value(phase);
+      Out(0, float(value) * HEMISPHERE_3V_CV);
     }
 
     void drawApplet() final
@@ -61,10 +189,55 @@ namespace NNoiseRampLfo
     }
 
   private:
+    void startSegment()
+    {
+      // new target between minus one and one
+      mPoints[0] = mPoints[1];
+      mPoints[1] = mPoints[2];
+      mPoints[2] = mPoints[3];
+      mPoints[3] = rand_.tick() * sample_t(2) - sample_t(1);
+      mSegment.start(mInterpolation, mPoints[0], mPoints[1], mPoints[2], mPoints[3]);
+      mHolding = false;
+
+      // Stepped value
+      Out(1, float(mPoints[2]) * HEMISPHERE_3V_CV);
+    }
+
+    void updateFrequency()
+    {
+      if (mSynced)
+      {
+        mPhasor.setFrequency(mClockFrequency);
+      }
+      else
+      {
+        // Rate CV is 1V/octave. This runs in the ISR whenever the CV moves, so
+        // whole octaves are a power of two and only the fraction goes through
+        // the exp2 table, as PitchPhasor does.
+        constexpr int kUnitsPerOctave = 12 << 7;
+        const int pitch = In(0);
+        int octave = pitch / kUnitsPerOctave;
+        int rest = pitch - octave * kUnitsPerOctave;
+        if (rest < 0)
+        {
+          rest += kUnitsPerOctave;
+          octave--;
+        }
+        const auto fraction = sample_t::fromValue(rest * ((1 << sample_t::shift_) / kUnitsPerOctave));
+        mPhasor.setFrequency(std::ldexp(mRate * float(fastmath::exp2(fraction)), octave));
+      }
+    }
+
     Phasor<sample_t> mPhasor;
-    float mLfoFrequency = .5f;
-    sample_t mInc = sample_t(0.001);
-    sample_t mValue = sample_t(0);
+    Segment mSegment;
+    Model::Interpolations mInterpolation = Model::Interpolations::Linear;
+    float mRate = .5f;
+    float mClockFrequency = .5f;
+    int mTicksSinceClock = 0;
+    int mLastPeriod = 0;
+    bool mSynced = false;
+    bool mHolding = false;
+    sample_t mPoints[4];
     Random<sample_t> rand_;
   };
 
@@ -23,6 +23,7 @@
 #include "braids_quantizer.h"
 #include "braids_quantizer_scales.h"
 #include "OC_scales.h"
+#include "vector_osc/HSVectorOscillator.h"
 
 //------------------------------------------------------------------------------
 
@@ -40,6 +41,10 @@ namespace NOscillator
       BRect,
       SharkTooth,
       Random,
+      TableSaw,
+      TableSquare,
+      TableTriangle,
+      TableUser,
       COUNT
     };
 
@@ -68,7 +73,7 @@ namespace NOscillator
       Waveform()
       {
         setValue(Waveforms::Sine);
-        setEnumStrings({"Sine", "QSine", "Tanh", "Satur", "Square", "BSquare", "Shark", "Random"});
+        setEnumStrings({"Sine", "QSine", "Tanh", "Satur", "Square", "BSquare", "Shark", "Random", "WSaw", "WSquare", "WTri", "WUser"});
       }
     };
 
@@ -112,8 +117,9 @@ namespace NOscillator
 
     void setDecay(float decayTime)
     {
-      eg_.setSlopes(16, uint32_t(kSampleRate * decayTime));
-      leg_.setSlopes(16, uint32_t(kSampleRate * decayTime));
+      const int decay = secondsToTimeUnits(decayTime, kSampleRate);
+      eg_.setTimes(kAttack, decay);
+      leg_.setTimes(kAttack, decay);
     }
 
     sample_t tick(const bool gate)
@@ -127,6 +133,9 @@ namespace NOscillator
     }
 
   private:
+    // 16 samples
+    static constexpr int kAttack = 4 * kTimeUnitsPerOctave;
+
     Envelopes envelope_;
     ADEnvelope<sample_t> eg_;
     LinearADEnvelope<sample_t> leg_;
@@ -196,9 +205,9 @@ namespace NOscillator
               break;
 
             case Model::Waveforms::BRect:
-              osc_.setTicker([](const sample_t& phase, const sample_t& phaseInc,const sample_t& /* shape */)
+              osc_.setTicker([this](const sample_t& phase, const sample_t& phaseInc,const sample_t& /* shape */)
               {
-                return (rectPolyBlep(phase, phaseInc) + sample_t(1)) * sample_t(0.5);
+                return (rectPolyBlep(phase, phaseInc, osc_.phaseIncInverse()) + sample_t(1)) * sample_t(0.5);
               });
               break;
 
@@ -216,6 +225,22 @@ namespace NOscillator
               });
               break;
 
+            case Model::Waveforms::TableSaw:
+              setTable(wavetables::Shapes::Saw);
+              break;
+
+            case Model::Waveforms::TableSquare:
+              setTable(wavetables::Shapes::Square);
+              break;
+
+            case Model::Waveforms::TableTriangle:
+              setTable(wavetables::Shapes::Triangle);
+              break;
+
+            case Model::Waveforms::TableUser:
+              setUserTable();
+              break;
+
             default:
               break;
           }
@@ -246,7 +271,7 @@ namespace NOscillator
           osc_.reset(kSampleRate);
         }
 
-        const auto shape = sample_t::fromRatio(In(1), float(HEMISPHERE_MAX_CV));
+        const auto shape = sample_t::fromValue(In(1)) * invMaxCV_;
 
         const float frequency = midiNoteToFrequency(lastNote_) ;
         osc_.setFrequency(frequency);
@@ -278,6 +303,36 @@ namespace NOscillator
       // }
 
   private:
+    void setTable(wavetables::Shapes shape)
+    {
+      const auto& table = wavetables::get(shape);
+      osc_.setTicker([&table](const sample_t& phase, const sample_t& phaseInc,const sample_t& /* shape */)
+      {
+        return table.read(phase, phaseInc);
+      });
+    }
+
+    // The first waveform of the waveform editor, built when selected
+    void setUserTable()
+    {
+      auto& table = wavetables::user();
+      for (int i = 0; i < HS::VO_SEGMENT_COUNT; i++)
+      {
+        if (HS::user_waveforms[i].IsTOC())
+        {
+          const int count = std::min<int>(HS::user_waveforms[i].Segments(), HS::VO_SEGMENT_COUNT - i - 1);
+          table.buildFromSegments(&HS::user_waveforms[i + 1], count);
+          break;
+        }
+      }
+      osc_.setTicker([&table](const sample_t& phase, const sample_t& phaseInc,const sample_t& /* shape */)
+      {
+        return table.read(phase, phaseInc);
+      });
+    }
+
+    // Shape CV scaling, without a division per tick
+    const sample_reciprocal_t invMaxCV_ = reciprocal(sample_t::fromValue(HEMISPHERE_MAX_CV));
     Oscillator<sample_t> osc_;
     Random<sample_t> rand_;
     SharkToothShape<sample_t> sharkShape_;
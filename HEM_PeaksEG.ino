@@ -0,0 +1,283 @@
+// Copyright (c) 2018, Marc Nostromo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "src/nostromo.h"
+
+#include "peaks_multistage_envelope.h"
+
+// The multistage envelope of Peaks. TR1 is the gate, CV1 adds to the
+// attack time and CV2 to the decay and release times. A is the envelope
+// (0-5V), B a trigger at the end of it.
+
+namespace NPeaksEG
+{
+  struct Model
+  {
+    enum class Modes
+    {
+      ADSR,
+      ADR,
+      AR,
+      AD,
+      ADSAR,
+      COUNT
+    };
+
+    // In the order of peaks::EnvelopeShape
+    enum class Shapes
+    {
+      Linear,
+      Exponential,
+      Quartic,
+      Sine,
+      Plateau,
+      Cliff,
+      Gate,
+      BigDipper,
+      MediumDipper,
+      LittleDipper,
+      Sinefold,
+      COUNT
+    };
+
+    // Segment times and the sustain level on 8 bits, as the O&C envelopes
+    struct Setting: Property<int>
+    {
+      Setting(const char* label, int value)
+      {
+        setLabel(label);
+        setRange(0, 255);
+        setValue(value);
+      }
+    };
+
+    struct Attack: Setting
+    {
+      Attack()
+      : Setting("a", 0)
+      {}
+    };
+
+    struct Decay: Setting
+    {
+      Decay()
+      : Setting("d", 32)
+      {}
+    };
+
+    struct Sustain: Setting
+    {
+      Sustain()
+      : Setting("s", 128)
+      {}
+    };
+
+    struct Release: Setting
+    {
+      Release()
+      : Setting("r", 128)
+      {}
+    };
+
+    struct Mode: Property<Modes>
+    {
+      Mode()
+      {
+        setValue(Modes::ADSR);
+        setEnumStrings({"ADSR", "ADR", "AR", "AD", "ADSAR"});
+      }
+    };
+
+    struct ShapeBase: Property<Shapes>
+    {
+      ShapeBase(Shapes value)
+      {
+        setValue(value);
+        setEnumStrings({"Lin", "Exp", "Qrt", "Sin", "Plt", "Clf", "Gat", "BDp", "MDp", "LDp", "SFd"});
+      }
+    };
+
+    struct AttackShape: ShapeBase
+    {
+      AttackShape()
+      : ShapeBase(Shapes::Quartic)
+      {}
+    };
+
+    // Decay and release
+    struct FallShape: ShapeBase
+    {
+      FallShape()
+      : ShapeBase(Shapes::Exponential)
+      {}
+    };
+
+    using Properties = PropertySet<Attack, Decay, Sustain, Release, Mode, AttackShape, FallShape>;
+  };
+
+  class Applet : public ArticCircleApplet<Model> {
+  public:
+    Applet()
+    {
+      // Maximum 9 characters
+      //       123456789
+      setName("Peaks EG");
+
+      envelope_.Init();
+
+      // Shapes next to the times they apply to, the level in between
+      setPosition<Model::AttackShape>(36, 0);
+      setPosition<Model::FallShape>(36, 27);
+
+      bind<Model::Attack>(attack_);
+      bind<Model::Decay>(decay_);
+      // Ramped in the ISR, the level is directly on output A
+      setCallback<Model::Sustain>([this](const int& sustain) {
+        sustain_.set(sustain << 7);
+      });
+      bind<Model::Release>(release_);
+
+      setCallback<Model::Mode>([this](const Model::Modes& mode) {
+        mode_ = mode;
+        configured_ = false;
+      });
+
+      // The shapes are copied to the segments when they are configured
+      setCallback<Model::AttackShape>([this](const Model::Shapes& shape) {
+        attackShape_ = peaks::EnvelopeShape(shape);
+        configured_ = false;
+      });
+
+      setCallback<Model::FallShape>([this](const Model::Shapes& shape) {
+        fallShape_ = peaks::EnvelopeShape(shape);
+        configured_ = false;
+      });
+    }
+
+    virtual void reset() final
+    {
+      envelope_.Init();
+      sustain_.reset();
+      configured_ = false;
+    }
+
+    virtual void tick() final
+    {
+      configure();
+
+      uint8_t control = Gate(0) ? peaks::CONTROL_GATE : 0;
+      if (flank_[0] == 1) control |= peaks::CONTROL_GATE_RISING;
+      if (flank_[0] == -1) control |= peaks::CONTROL_GATE_FALLING;
+
+      value_ = envelope_.ProcessSingleSample(control);
+      Out(0, (int32_t(value_) * HEMISPHERE_MAX_CV) >> 15);
+
+      if (envelope_.get_state_mask() & peaks::ENV_EOC)
+      {
+        ClockOut(1);
+      }
+    }
+
+    void drawApplet() final
+    {
+      ArticCircleApplet<NPeaksEG::Model>::drawApplet();
+
+      gfxFrame(36, 29, 26, 5);
+      gfxRect(36, 29, (int32_t(value_) * 26) >> 15, 5);
+    }
+
+  private:
+    // The envelope caches the increments of its segments, so setting the
+    // times only costs when a setting or a CV actually moves them
+    void configure()
+    {
+      const int attackCV = Proportion(In(0), HEMISPHERE_MAX_CV, 255);
+      const int fallCV = Proportion(In(1), HEMISPHERE_MAX_CV, 255);
+      const uint16_t attack = constrain(attack_ + attackCV, 0, 255) << 8;
+      const uint16_t decay = constrain(decay_ + fallCV, 0, 255) << 8;
+      const uint16_t release = constrain(release_ + fallCV, 0, 255) << 8;
+      const uint16_t sustain = sustain_.tick();
+
+      if (configured_ && attack == attackTime_ && decay == decayTime_
+        && release == releaseTime_ && sustain == sustainLevel_)
+      {
+        return;
+      }
+      configured_ = true;
+      attackTime_ = attack;
+      decayTime_ = decay;
+      releaseTime_ = release;
+      sustainLevel_ = sustain;
+
+      envelope_.set_attack_shape(attackShape_);
+      envelope_.set_decay_shape(fallShape_);
+      envelope_.set_release_shape(fallShape_);
+
+      switch (mode_)
+      {
+        case Model::Modes::ADR:
+          envelope_.set_adr(attack, decay, sustain, release, 0, 0);
+          break;
+        case Model::Modes::AR:
+          envelope_.set_ar(attack, release);
+          break;
+        case Model::Modes::AD:
+          envelope_.set_ad(attack, decay, 0, 0);
+          break;
+        case Model::Modes::ADSAR:
+          envelope_.set_adsar(attack, decay, sustain, release);
+          break;
+        default:
+          envelope_.set_adsr(attack, decay, sustain, release);
+          break;
+      }
+      // Restarts if the current segment is beyond the ones of the new mode
+      envelope_.reset();
+    }
+
+    Model::Modes mode_ = Model::Modes::ADSR;
+    int attack_ = 0;
+    int decay_ = 0;
+    DezipperedValue<int> sustain_;
+    int release_ = 0;
+    peaks::EnvelopeShape attackShape_ = peaks::ENV_SHAPE_QUARTIC;
+    peaks::EnvelopeShape fallShape_ = peaks::ENV_SHAPE_EXPONENTIAL;
+    bool configured_ = false;
+    uint16_t attackTime_ = 0;
+    uint16_t decayTime_ = 0;
+    uint16_t releaseTime_ = 0;
+    uint16_t sustainLevel_ = 0;
+    uint16_t value_ = 0;
+    peaks::MultistageEnvelope envelope_;
+  };
+
+  Applet instance_[2];
+
+} // NPeaksEG
+
+void PeaksEG_Start(bool hemisphere) {NPeaksEG::instance_[hemisphere].BaseStart(hemisphere);}
+void PeaksEG_Controller(bool hemisphere, bool forwarding) {NPeaksEG::instance_[hemisphere].BaseController(forwarding);}
+void PeaksEG_View(bool hemisphere) {NPeaksEG::instance_[hemisphere].BaseView();}
+void PeaksEG_OnButtonPress(bool hemisphere) {NPeaksEG::instance_[hemisphere].OnButtonPress();}
+void PeaksEG_OnEncoderMove(bool hemisphere, int direction) {NPeaksEG::instance_[hemisphere].OnEncoderMove(direction);}
+void PeaksEG_ToggleHelpScreen(bool hemisphere) {NPeaksEG::instance_[hemisphere].HelpScreen();}
+uint32_t PeaksEG_OnDataRequest(bool hemisphere) {return NPeaksEG::instance_[hemisphere].OnDataRequest();}
+void PeaksEG_OnDataReceive(bool hemisphere, uint32_t data) {NPeaksEG::instance_[hemisphere].OnDataReceive(data);}
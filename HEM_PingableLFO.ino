@@ -24,7 +24,70 @@ namespace NPingableLfo
 {
   struct Model
   {
-    using Properties = PropertySet<>;
+    enum class Shapes
+    {
+      Saw,
+      Ramp,
+      Triangle,
+      Sine,
+      Square,
+      COUNT
+    };
+
+    enum class Ratios
+    {
+      Div8,
+      Div4,
+      Div3,
+      Div2,
+      One,
+      Mul2,
+      Mul3,
+      Mul4,
+      Mul8,
+      COUNT
+    };
+
+    struct Shape: Property<Shapes>
+    {
+      Shape()
+      {
+        setValue(Shapes::Saw);
+        setEnumStrings({"Saw", "Ramp", "Tri", "Sine", "Sqr"});
+      }
+    };
+
+    // Ratio of output B to the tracked tempo
+    struct Ratio: Property<Ratios>
+    {
+      Ratio()
+      {
+        setValue(Ratios::Mul2);
+        setEnumStrings({"/8", "/4", "/3", "/2", "x1", "x2", "x3", "x4", "x8"});
+      }
+    };
+
+    // Loop gain of the phase correction
+    struct Gain: PercentageProperty
+    {
+      Gain()
+      {
+        setValue(0.25f);
+      }
+    };
+
+    // Number of clock intervals averaged for the tempo
+    struct Average: Property<int>
+    {
+      Average()
+      {
+        setRange(1, TempoTracker::kMaxIntervals);
+        setValue(4);
+        setLabel("avg");
+      }
+    };
+
+    using Properties = PropertySet<Shape, Ratio, Gain, Average>;
   };
 
   class Applet : public ArticCircleApplet<Model> {
@@ -34,22 +97,44 @@ namespace NPingableLfo
       // Maximum 9 characters
       //       123456789
       setName("Ping LFO");
+
+      bind<Model::Shape>(shape_);
+
+      setCallback<Model::Ratio>([this](const Model::Ratios &r) {
+        const int ratios[] = {-8, -4, -3, -2, 1, 2, 3, 4, 8};
+        ratio_ = ratios[int(r)];
+        divider_.setAmount(-ratio_);
+      });
+
+      setCallback<Model::Gain>([this](const float &gain) {
+        phaser_.setLoopGain(gain);
+      });
+
+      setCallback<Model::Average>([this](const int &count) {
+        phaser_.setAverageCount(count);
+      });
     }
 
     virtual void reset() final
     {
-      phaser_.reset(kSampleRate);
+      // Pings are timestamped with the cycle counter for sub-tick accuracy
+      phaser_.reset(kSampleRate, float(F_CPU));
+      divider_.reset();
     }
 
     virtual void tick()
     {
-      const bool gate = Gate(0);
-      if (gate && (lastGate_ != gate))
+      if (Clock(0, true))
       {
-        phaser_.ping(OC::CORE::ticks);
+        phaser_.ping(ClockCycles(0));
       }
-      lastGate_ =gate;
-      Out(0,float(phaser_.tick()) * HEMISPHERE_MAX_CV);
+      const auto phase = phaser_.tick();
+      // The divider has to see every cycle to stay in phase
+      const auto divided = divider_.tick(phase);
+      const auto ratioPhase = (ratio_ < 0) ? divided : sample_t::frac(phase * sample_t(ratio_));
+
+      Out(0, float(shape(phase)) * HEMISPHERE_MAX_CV);
+      Out(1, float(shape(ratioPhase)) * HEMISPHERE_MAX_CV);
     }
 
     void drawApplet() final
@@ -61,8 +146,31 @@ namespace NPingableLfo
     }
 
   private:
+    // Unipolar shapes
+    sample_t shape(const sample_t& phase) const
+    {
+      switch (shape_)
+      {
+        case Model::Shapes::Saw:
+          return phase;
+        case Model::Shapes::Ramp:
+          return sample_t(1) - phase;
+        case Model::Shapes::Triangle:
+        {
+          const auto t = phase * sample_t(2);
+          return (t < sample_t(1)) ? t : sample_t(2) - t;
+        }
+        case Model::Shapes::Sine:
+          return (Sine(phase) + sample_t(1)) * sample_t(0.5);
+        default:
+          return (phase < sample_t(0.5)) ? sample_t(1) : sample_t(0);
+      }
+    }
+
     PingablePhaser phaser_;
-    bool lastGate_ = false;
+    PhaserDivider divider_;
+    Model::Shapes shape_ = Model::Shapes::Saw;
+    int ratio_ = 2;
   };
 
   Applet instance_[2];
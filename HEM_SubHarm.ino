@@ -20,10 +20,53 @@
 
 #include "src/nostromo.h"
 
+// Two modes:
+// - CV: A is the pitch input shifted down to the n-th subharmonic, B passes
+//   the input through.
+// - Osc: the pitch input drives a master oscillator, and A and B are two
+//   integer subdivisions of it, phase coherent with each other. CV2 adds up
+//   to 15 steps to the divisions it targets, a rising gate on TR1 syncs all
+//   of them.
+
 namespace NSubHarm
 {
+  constexpr int kMaxDivision = 16;
+
   struct Model
   {
+    enum class Modes
+    {
+      CV,
+      Osc,
+      COUNT
+    };
+
+    enum class Waves
+    {
+      Saw,
+      Triangle,
+      Square,
+      Gate,
+      COUNT
+    };
+
+    enum class Targets
+    {
+      Both,
+      Sub1,
+      Sub2,
+      COUNT
+    };
+
+    struct Mode : Property<Modes>
+    {
+      Mode()
+      {
+        setValue(Modes::CV);
+        setEnumStrings({"CV", "Osc"});
+      }
+    };
+
     struct Offset : Property<int>
     {
       Offset()
@@ -34,7 +77,46 @@ namespace NSubHarm
       }
     };
 
-    using Properties = PropertySet<Offset>;
+    struct Sub1 : Property<int>
+    {
+      Sub1()
+      {
+        setLabel("s1");
+        setRange(1, kMaxDivision);
+        setValue(2);
+      }
+    };
+
+    struct Sub2 : Property<int>
+    {
+      Sub2()
+      {
+        setLabel("s2");
+        setRange(1, kMaxDivision);
+        setValue(3);
+      }
+    };
+
+    struct Wave : Property<Waves>
+    {
+      Wave()
+      {
+        setValue(Waves::Saw);
+        setEnumStrings({"Saw", "Tri", "Sqr", "Gate"});
+      }
+    };
+
+    // Divisions offset by CV2
+    struct Target : Property<Targets>
+    {
+      Target()
+      {
+        setValue(Targets::Both);
+        setEnumStrings({"cv:1+2", "cv:1", "cv:2"});
+      }
+    };
+
+    using Properties = PropertySet<Mode, Offset, Sub1, Sub2, Wave, Target>;
   };
 
 
@@ -46,27 +128,145 @@ namespace NSubHarm
       //       123456789
       setName("SubHarm");
 
+      // Offset is only shown in CV mode, the others in Osc mode
+      setPosition<Model::Sub1>(0, 9);
+      setPosition<Model::Sub2>(0, 18);
+      setPosition<Model::Wave>(0, 27);
+      setPosition<Model::Target>(0, 36);
+
+      setCallback<Model::Mode>([this](const Model::Modes& m) {
+        mode_ = m;
+        const bool osc = (m == Model::Modes::Osc);
+        setVisibility<Model::Offset>(!osc);
+        setVisibility<Model::Sub1>(osc);
+        setVisibility<Model::Sub2>(osc);
+        setVisibility<Model::Wave>(osc);
+        setVisibility<Model::Target>(osc);
+      });
+
       setCallback<Model::Offset>([this](const auto& o) {
-        offset_ = std::log2(1.f/float(o));
+        offset_ = -float(fastmath::log2(sample_t(int(o))));
       });
+
+      bind<Model::Sub1>(sub_[0].setting);
+      bind<Model::Sub2>(sub_[1].setting);
+      bind<Model::Wave>(wave_);
+      bind<Model::Target>(target_);
     }
 
-    virtual void reset() final {};
+    virtual void reset() final
+    {
+      // The master tracks the pitch CV, so reject spikes and smooth it lightly
+      // (1/4) rather than let the subs jump on ADC noise
+      ConfigureInput(0, {true, 2, 0, 0});
+
+      // 0V is C4
+      master_.reset(kSampleRate, 261.63f);
+      for (auto& sub: sub_)
+      {
+        sub.division = 0;
+        sub.divider.reset();
+      }
+    };
 
     virtual void tick() final
     {
-      float cvInput = In(0);
-      Out(0, cvInput + offset_ * HEMISPHERE_3V_CV / 3.f);
-      Out(1, cvInput);
+      if (mode_ == Model::Modes::CV)
+      {
+        float cvInput = In(0);
+        Out(0, cvInput + offset_ * HEMISPHERE_3V_CV / 3.f);
+        Out(1, cvInput);
+        return;
+      }
+
+      master_.setPitch(In(0));
+      updateDivisions();
+
+      if (flankUp(0))
+      {
+        master_.sync();
+        for (auto& sub: sub_)
+        {
+          sub.divider.reset();
+        }
+      }
+
+      // The dividers see every master cycle, so the subs stay aligned
+      const auto phase = master_.tick();
+      ForEachChannel(ch)
+      {
+        sub_[ch].phase = sub_[ch].divider.tick(phase);
+        output(ch, sub_[ch].phase);
+      }
     }
 
     void drawApplet() final
     {
       ArticCircleApplet<NSubHarm::Model>::drawApplet();
+
+      if (mode_ == Model::Modes::Osc)
+      {
+        ForEachChannel(ch)
+        {
+          const int y = 15 + ch * 18;
+          gfxPrint(40, y, "/");
+          gfxPrint(sub_[ch].division);
+          gfxFrame(40, y + 9, 22, 5);
+          gfxRect(40 + ((sub_[ch].phase.value_ >> (sample_t::shift_ - 5)) * 20 >> 5), y + 9, 2, 5);
+        }
+      }
     }
 
   private:
+    struct Sub
+    {
+      int setting = 1;
+      int division = 0;
+      PhaserDivider divider;
+      sample_t phase;
+    };
+
+    void updateDivisions()
+    {
+      const int cvSteps = Proportion(In(1), HEMISPHERE_MAX_CV, kMaxDivision - 1);
+      ForEachChannel(ch)
+      {
+        const bool targeted = (target_ == Model::Targets::Both) || (int(target_) == ch + 1);
+        const int division = constrain(sub_[ch].setting + (targeted ? cvSteps : 0), 1, kMaxDivision);
+        // setAmount divides, so only when needed
+        if (division != sub_[ch].division)
+        {
+          sub_[ch].division = division;
+          sub_[ch].divider.setAmount(division);
+        }
+      }
+    }
+
+    void output(int ch, const sample_t& phase)
+    {
+      switch (wave_)
+      {
+        case Model::Waves::Saw:
+          Out(ch, toCV(saw(phase), HEMISPHERE_3V_CV));
+          break;
+        case Model::Waves::Triangle:
+          Out(ch, toCV(triangle(phase), HEMISPHERE_3V_CV));
+          break;
+        case Model::Waves::Square:
+          Out(ch, toCV(rect(phase), HEMISPHERE_3V_CV));
+          break;
+        default:
+          GateOut(ch, phase < sample_t(0.5));
+          break;
+      }
+    }
+
+    Model::Modes mode_ = Model::Modes::CV;
+    Model::Waves wave_ = Model::Waves::Saw;
+    Model::Targets target_ = Model::Targets::Both;
     float offset_;
+    PitchPhasor master_;
+    Sub sub_[2];
   };
 
   Applet instance_[2];
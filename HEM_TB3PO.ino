@@ -36,6 +36,8 @@
 
 #define ACID_HALF_STEPS 16
 #define ACID_MAX_STEPS 32
+#define ACID_BANK_SLOTS 4
+#define ACID_RECALL_READY 5
 
 class TB_3PO : public HemisphereApplet 
 {
@@ -81,6 +83,22 @@ class TB_3PO : public HemisphereApplet
       
       //transpose_note_in = 0;    
 
+      // Fill the bank with some random favorites to start from, only the first
+      // time: it's kept when switching applets, and restored with the settings
+      if(!bank_filled)
+      {
+        for(int i=0; i<ACID_BANK_SLOTS; ++i)
+        {
+          reseed();
+          bank[i] = {seed, density, uint8_t(scale)};
+        }
+        bank_filled = true;
+      }
+      bank_slot = 0;
+      bank_cv = 0;
+      recall_slot = 0;
+      recall_phase = 0;
+
       lock_seed = 0;
       reseed();
       regenerate_all();
@@ -96,16 +114,28 @@ class TB_3PO : public HemisphereApplet
       if (Clock(1) || manual_reset_flag) 
       {
         manual_reset_flag = 0;
-        // If the seed is not locked, then randomize it on every reset pulse
-        // Otherwise, the user has locked it, so leave it as set
-        if(lock_seed == 0)
+        if(recall_phase > 0)
         {
-          reseed();
+          // A reset is a downbeat too, so switch to the recalled pattern now (finishing it if needed)
+          while(recall_phase < ACID_RECALL_READY)
+          {
+            update_recall();
+          }
+          apply_recalled_pattern();
         }
+        else
+        {
+          // If the seed is not locked, then randomize it on every reset pulse
+          // Otherwise, the user has locked it, so leave it as set
+          if(lock_seed == 0)
+          {
+            reseed();
+          }
 
-        // Apply the seed to regenerate the pattern`
-        // This is deterministic so if the seed is held, the pattern will not change
-        regenerate_all();
+          // Apply the seed to regenerate the pattern`
+          // This is deterministic so if the seed is held, the pattern will not change
+          regenerate_all();
+        }
 
         // Reset step
         step = 0;
@@ -132,6 +162,18 @@ class TB_3PO : public HemisphereApplet
         //transpose_note_in = quantizer.GetLatestNoteNumber() - 64;  // For debug readout!
        }
 
+      if(bank_cv)
+      {
+        // cv2 selects the bank slot to recall instead (0-5v)
+        int slot = Proportion(constrain(In(1), 0, HEMISPHERE_MAX_CV - 1), HEMISPHERE_MAX_CV, ACID_BANK_SLOTS);
+        if(slot != recall_slot)
+        {
+          recall(slot);
+        }
+        density_cv = 0;
+        density = static_cast<uint8_t>(density_encoder);
+      }
+      else
       // Offset density from its encoder-set value with cv2 (Wiggling can build up & break down patterns nicely, especially if seed is locked)
       {
         // -2.5v to +5v (HEMISPHERE_MAX_CV),  giving about -8 to +15 added to encoder density value
@@ -159,16 +201,24 @@ class TB_3PO : public HemisphereApplet
       if (EndOfADCLag() && !Gate(1))  // Reset not held
       {
         int step_pv = step;
+        bool slid_pv = step_is_slid(step_pv);
+        int pitch_pv = get_pitch_for_step(step_pv);
         
         // Advance the step
         step = get_next_step(step);
 
+        // Switch to a recalled pattern on the downbeat once it's ready
+        if(step == 0 && recall_phase == ACID_RECALL_READY)
+        {
+          apply_recalled_pattern();
+        }
+
         // Was step before this one set to 'slide'?
         // If so, engage a the 'slide circuit' from its pitch to this new step's pitch
-        if(step_is_slid(step_pv))
+        if(slid_pv)
         {
           // Slide begins from the prior step's pitch (TODO: just use current dac output?)
-          slide_start_cv = get_pitch_for_step(step_pv);
+          slide_start_cv = pitch_pv;
 
           // Jump current pitch to prior step's value if not there already
           // TODO: Consider just gliding from whereever it is?
@@ -186,7 +236,7 @@ class TB_3PO : public HemisphereApplet
         }
   
         // Open the gate if this step is gated, or hold it open for at least 1/2 step if the prior step was slid
-        if(step_is_gated(step) || step_is_slid(step_pv))
+        if(step_is_gated(step) || slid_pv)
         {
           // Accented gates get a higher voltage, so it can drive VCA gain in addition to triggering envelope generators
           curr_gate_cv = step_is_accent(step) ? HEMISPHERE_MAX_CV : HEMISPHERE_3V_CV;
@@ -254,10 +304,10 @@ class TB_3PO : public HemisphereApplet
       Out(1, curr_gate_cv);
 
 
-      // Timesliced generation of new patterns, if triggered
+      // Generation of new patterns, if triggered
       // Do this last to not interfere with the body of the time for this hemisphere's update
-      // (This is speculation without knowing how to best profile performance on this system)
-      update_regeneration();   
+      update_regeneration();
+      update_recall();
     }
 
     void View() {
@@ -271,7 +321,7 @@ class TB_3PO : public HemisphereApplet
       {
         cursor = lock_seed ? 1 : 5;
       }
-      else if (++cursor > 8) 
+      else if (++cursor > 9) 
       {
         cursor = 0;
       }
@@ -369,13 +419,33 @@ class TB_3PO : public HemisphereApplet
         root = constrain(r, 0, max_root-1);
 
       }
-      else
+      else if(cursor == 8)
       {
         num_steps = constrain(num_steps + direction, 1, 32);
       }
+      else
+      {
+        // Bank slot selection; one past the last slot selects the slot with cv2 instead
+        int sel = constrain((bank_cv ? ACID_BANK_SLOTS : recall_slot) + direction, 0, ACID_BANK_SLOTS);
+        bank_cv = (sel == ACID_BANK_SLOTS);
+        if(!bank_cv)
+        {
+          recall(sel);
+        }
+      }
+
+      // While the seed is locked, the playing bank slot follows the edits
+      if(lock_seed && recall_phase == 0)
+      {
+        bank[bank_slot] = {seed, uint8_t(density_encoder), uint8_t(scale)};
+      }
     }
 
     uint32_t OnDataRequest() {
+        // The bank doesn't fit in 32 bits, so it's a journal chunk of its own.
+        // Unchanged banks aren't written again.
+        OC::apps::WriteChunk(bank_chunk_id(), bank, sizeof(bank));
+
         uint32_t data = 0;
 		
         Pack(data, PackLocation {0,8}, scale);
@@ -392,6 +462,18 @@ class TB_3PO : public HemisphereApplet
       density_encoder = Unpack(data, PackLocation {12,4});
       seed = Unpack(data, PackLocation {16,16});
 
+      BankSlot saved_bank[ACID_BANK_SLOTS];
+      if(OC::apps::ReadChunk(bank_chunk_id(), saved_bank, sizeof(saved_bank)))
+      {
+        for(int i=0; i<ACID_BANK_SLOTS; ++i)
+        {
+          bank[i].seed = saved_bank[i].seed;
+          bank[i].density = constrain(saved_bank[i].density, 0, 14);
+          bank[i].scale = constrain(saved_bank[i].scale, 0, OC::Scales::NUM_SCALES-1);
+        }
+        bank_filled = true;
+      }
+
       //const braids::Scale & quant_scale = OC::Scales::GetScale(scale);
       set_quantizer_scale(scale);
       
@@ -411,9 +493,9 @@ class TB_3PO : public HemisphereApplet
     void SetHelp() {
         //                               "------------------" <-- Size Guide
         help[HEMISPHERE_HELP_DIGITALS] = "1=Clock 2=Regen";
-        help[HEMISPHERE_HELP_CVS]      = "1=Transp 2=Density";
+        help[HEMISPHERE_HELP_CVS]      = "1=Transp 2=Dns/Slt";
         help[HEMISPHERE_HELP_OUTS]     = "A=CV+glide B=Gate";
-        help[HEMISPHERE_HELP_ENCODER]  = "seed/dens/qnt/len";
+        help[HEMISPHERE_HELP_ENCODER]  = "seed/dns/qnt/ln/bk";
         //                               "------------------" <-- Size Guide
     }
     
@@ -458,12 +540,34 @@ class TB_3PO : public HemisphereApplet
     int32_t transpose_cv;  // Quantized transpose in cv
 
     // Generated sequence data
-    uint32_t gates = 0; 		// Bitfield of gates;  ((gates >> step) & 1) means gate
-    uint32_t slides = 0; 	// Bitfield of slide steps; ((slides >> step) & 1) means slide
-    uint32_t accents = 0;   // Bitfield of accent steps; ((accents >> step) & 1) means accent
-    uint32_t oct_ups = 0;   // Bitfield of octave ups
-    uint32_t oct_downs = 0;   // Bitfield of octave downs
-    uint8_t notes[ACID_MAX_STEPS];  // Note values
+    struct AcidPattern
+    {
+      uint32_t gates; 		// Bitfield of gates;  ((gates >> step) & 1) means gate
+      uint32_t slides; 	// Bitfield of slide steps; ((slides >> step) & 1) means slide
+      uint32_t accents;   // Bitfield of accent steps; ((accents >> step) & 1) means accent
+      uint32_t oct_ups;   // Bitfield of octave ups
+      uint32_t oct_downs;   // Bitfield of octave downs
+      uint8_t notes[ACID_MAX_STEPS];  // Note values
+    };
+
+    // The playing pattern, and the other one a recalled bank slot is generated into in the background
+    AcidPattern patterns[2] = {};
+    uint8_t play_pattern = 0;
+
+    // Bank of favorites
+    struct BankSlot
+    {
+      uint16_t seed;
+      uint8_t density;  // Encoder density, 0-14
+      uint8_t scale;
+    };
+
+    BankSlot bank[ACID_BANK_SLOTS];
+    bool bank_filled = false;  // The bank is only filled with random favorites once
+    uint8_t bank_slot;    // Slot that is playing
+    uint8_t recall_slot;  // Slot to play next (same as bank_slot if none is pending)
+    uint8_t recall_phase; // 0 = idle, 1-4 = generating, 5 = ready to switch on the next downbeat
+    bool bank_cv;         // Select the slot with cv2 instead of the encoder
 
     uint8_t scale_size;  // The size of the currently set quantizer scale (for octave detection, etc)
     uint8_t current_pattern_scale_size; // Track what size scale was used to render the current pattern (for change detection)
@@ -486,7 +590,9 @@ class TB_3PO : public HemisphereApplet
     
     uint8_t rand_apply_anim = 0;  // Countdown to animate icons for when regenerate occurs
 
-    uint8_t regenerate_phase = 0;  // Split up random generation over multiple frames
+    uint8_t regenerate_phase = 0;  // Pending regeneration flag, and current phase while regenerating
+
+    uint32_t rng_state = 0x2545f491;  // State of the per-instance random generator
   
     // Get the cv value to use for a given step including root + transpose values
     int get_pitch_for_step(int step_num)
@@ -494,7 +600,7 @@ class TB_3PO : public HemisphereApplet
       // Original: Transpose pre-quantize
       //int quant_note = 64 + int(notes[step_num]) +  int(root) + int(transpose_note_in);
 
-      int quant_note = 64 + int(notes[step_num]) +  int(root);
+      int quant_note = 64 + int(patterns[play_pattern].notes[step_num]) +  int(root);
 
       // Apply the manual octave offset
       quant_note += (int(octave_offset) * int(scale_size));
@@ -524,7 +630,7 @@ class TB_3PO : public HemisphereApplet
     int get_semitone_for_step(int step_num)
     {
       // Don't add in octaves-- use the current quantizer limited to the base octave
-      int quant_note = 64 + notes[step_num] + root;// + transpose_note_in;
+      int quant_note = 64 + patterns[play_pattern].notes[step_num] + root;// + transpose_note_in;
       int32_t cv_note = quantizer.Lookup( constrain(quant_note, 0, 127));
       display_semi_quantizer.Process(cv_note, 0, 0);  // Use root == 0 to start at c
       return display_semi_quantizer.GetLatestNoteNumber() % 12;
@@ -532,11 +638,11 @@ class TB_3PO : public HemisphereApplet
 
     void reseed()
     {
-      randomSeed(micros());
-      seed = random(0, 65535); // 16 bits
+      rand_seed(micros() ^ (uint32_t(seed) << 16));
+      seed = rand_next() >> 16; // 16 bits
     }
     
-  	// Trigger generating the sequence deterministically using the seed (over the next couple of Controller() calls)
+  	// Trigger generating the sequence deterministically using the seed (at the end of this Controller() call)
   	void regenerate_all()
   	{
       regenerate_phase = 1;  // Set to regenerate on loop
@@ -555,50 +661,120 @@ class TB_3PO : public HemisphereApplet
       }
     }
 
-    // Amortize random generation over multiple frames
-    // Without having profiled this properly, I'm less concerned about overrunning isr times alloted to this app if it's amortized
+    // Regenerate all 32 steps in one go
+    // The applet's own generator is cheap enough that this doesn't need to be amortized over multiple frames anymore
     void update_regeneration()
     {
       if(regenerate_phase == 0)
       {
         return;
       }
-      
-      randomSeed(seed+regenerate_phase);  // Ensure random()'s seed at each phase for determinism (note: offset to decouple phase behavior correllations that would result)
-      
-      switch(regenerate_phase)
+
+      // The phases are kept so each half of the pattern is generated exactly as before
+      for(regenerate_phase = 1; regenerate_phase <= 4; ++regenerate_phase)
+      {
+        generate_phase(patterns[play_pattern], regenerate_phase, seed, density, scale_size);
+      }
+      regenerate_phase = 0;
+
+      // Handle size as semitone scale for display if 'off'
+      if(scale_size == 0)
+      {
+        scale_size = 12;
+      }
+
+      // Track the values used to render the pattern (to detect changes)
+      current_pattern_density = density;
+      current_pattern_scale_size = scale_size;
+    }
+
+    void generate_phase(AcidPattern &pattern, int phase, uint16_t pattern_seed, uint8_t dens, uint8_t scale_sz)
+    {
+      rand_seed(pattern_seed+phase);  // Reseed at each phase for determinism (note: offset to decouple phase behavior correllations that would result)
+
+      bool bFirstHalf = phase < 3;
+      switch(phase)
       {
         // 1st set of 16 steps
-        case 1: regenerate_pitches(); ++regenerate_phase; break;
-        //case 2: apply_density(); regenerate_phase = 0; break;
-        case 2: apply_density(); ++regenerate_phase;break;
+        case 1: regenerate_pitches(pattern, bFirstHalf, dens, scale_sz); break;
+        case 2: apply_density(pattern, bFirstHalf, dens); break;
         // 2nd set of 16 steps
-        case 3: regenerate_pitches(); ++regenerate_phase; break;      
-        // After doing the 2nd set of bitvectors, swap the low and high 16 bits to align the first 16 steps to the steps they would have had
-        // when this app only rendered 16 steps
-        //case 4: apply_density(); restore_legacy_byte_orders(); regenerate_phase = 0; break;
-        case 4: apply_density(); regenerate_phase = 0; break;
+        case 3: regenerate_pitches(pattern, bFirstHalf, dens, scale_sz); break;
+        case 4: apply_density(pattern, bFirstHalf, dens); break;
         default: break;
       }
     }
 
+    // Journal chunk holding the bank of this hemisphere, see OC::apps::WriteChunk
+    uint16_t bank_chunk_id() const
+    {
+      return hemisphere ? TWOCC<'T','R'>::value : TWOCC<'T','L'>::value;
+    }
+
+    // Queue a bank slot to play from the next downbeat
+    void recall(int slot)
+    {
+      recall_slot = slot;
+      recall_phase = 1;
+    }
+
+    // Generate the recalled pattern in the background, one phase per Controller() call
+    void update_recall()
+    {
+      if(recall_phase == 0 || recall_phase == ACID_RECALL_READY)
+      {
+        return;
+      }
+
+      const BankSlot &slot = bank[recall_slot];
+      uint8_t scale_sz = OC::Scales::GetScale(slot.scale).num_notes;
+      generate_phase(patterns[play_pattern ^ 1], recall_phase, slot.seed, slot.density, scale_sz);
+      ++recall_phase;
+    }
+
+    // Switch to the recalled pattern, and take over its settings
+    void apply_recalled_pattern()
+    {
+      const BankSlot &slot = bank[recall_slot];
+      play_pattern ^= 1;
+      bank_slot = recall_slot;
+      recall_phase = 0;
+
+      seed = slot.seed;
+      lock_seed = 1;  // Keep the favorite when reset
+      density_encoder = slot.density;
+      density = slot.density;
+      scale = slot.scale;
+      set_quantizer_scale(scale);
+      if(scale_size == 0)
+      {
+        scale_size = 12;
+      }
+      int max_root = scale_size > 12 ? 12 : scale_size;
+      root = constrain(root, 0, max_root-1);
+
+      current_pattern_density = density;
+      current_pattern_scale_size = scale_size;
+      rand_apply_anim = 40;
+    }
+
       
     // Generate the notes sequence based on the seed and modified by density
-    void regenerate_pitches()
+    // 32 steps are computed across two passes of this function
+    void regenerate_pitches(AcidPattern &pattern, bool bFirstHalf, uint8_t dens, uint8_t scale_sz)
     {
-
-      // 32 steps are computed across two passes of this function
-      // Determine if the first 16 or second 16 steps are being handled here
-      bool bFirstHalf = regenerate_phase < 3;
+      uint32_t &oct_ups = pattern.oct_ups;
+      uint32_t &oct_downs = pattern.oct_downs;
+      uint8_t *notes = pattern.notes;
 
       // How much pitch variety to use from the available pitches (one of the factors of the 'density' control when < centerpoint)
-      int pitch_change_dens = get_pitch_change_density();   
+      int pitch_change_dens = get_pitch_change_density(dens);   
       int available_pitches = 0;
-      if(scale_size > 0)
+      if(scale_sz > 0)
       {
         if(pitch_change_dens > 7)
         {
-          available_pitches = scale_size-1;
+          available_pitches = scale_sz-1;
         }
         else if(pitch_change_dens < 2)
         {
@@ -607,14 +783,14 @@ class TB_3PO : public HemisphereApplet
         }
         else  // Range 3-7
         {
-          int range_from_scale = scale_size - 3;
+          int range_from_scale = scale_sz - 3;
           if(range_from_scale < 4)  // Ok to saturate at full note count
           {
             range_from_scale = 4;
           }
           // Range from 2 pitches to just <= full scale available
           available_pitches = 3 + Proportion(pitch_change_dens-3, 4, range_from_scale);
-          available_pitches = constrain(available_pitches, 1, scale_size -1);
+          available_pitches = constrain(available_pitches, 1, scale_sz -1);
         }
       }
 
@@ -641,7 +817,7 @@ class TB_3PO : public HemisphereApplet
         {
           // Grab a random note index from the scale's available pitches
           // Since this starts at 0, the root note will always be included, and adjacent scale notes are included as the range grows
-          notes[s] = random(0,available_pitches+1);  // Looking at the source, random(min,max) appears to return the range: min to max-1
+          notes[s] = rand_range(available_pitches+1);  // Range: 0 to available_pitches
 
           // Random oct up or down (Treating octave based on the scale's number of notes)
           oct_ups <<= 1;
@@ -661,27 +837,22 @@ class TB_3PO : public HemisphereApplet
         }      
       }
 
-      // Handle size as semitone scale for display if 'off'
-      if(scale_size == 0)
-      {
-        scale_size = 12;
-      }
-
-      current_pattern_scale_size = scale_size;
   	}
     
   	// Change pattern density without affecting pitches
-  	void apply_density()
+  	void apply_density(AcidPattern &pattern, bool bFirstHalf, uint8_t dens)
   	{
+      uint32_t &gates = pattern.gates;
+      uint32_t &slides = pattern.slides;
+      uint32_t &accents = pattern.accents;
   		int latest_slide = 0; // Track previous bit for some algos
       int latest_accent = 0; // Track previous bit for some algos
   		
       // Get gate probability from the 'density' value
-      int on_off_dens = get_on_off_density();
+      int on_off_dens = get_on_off_density(dens);
       int densProb = 10 + on_off_dens * 14;  // Should start >0 and reach 100+
 
       // Clear if this is the first 16 steps to generate (otherwise append to these bit vectors for the 2nd set of 16)
-      bool bFirstHalf = regenerate_phase < 3;
       if(bFirstHalf)
       {
         gates = 0;
@@ -706,49 +877,45 @@ class TB_3PO : public HemisphereApplet
         latest_accent = rand_bit((latest_accent ? 7 : 16));
         accents |= latest_accent;       
   		}
-
-      // Track the value of density used to render the pattern (to detect changes)
-      current_pattern_density = density;
-
   	}
  
     // Get on/off likelihood from the current value of 'density'
-    int get_on_off_density()
+    int get_on_off_density(uint8_t dens)
     {
       // density has a range 0-14
       // Convert density to a bipolar value from -7..+7, with the +-7 extremes in either direction 
       // as high note density, and the 0 point as lowest possible note density
-      int note_dens = int(density) - 7;
+      int note_dens = int(dens) - 7;
       return abs(note_dens);
     }
 
     // Get the degree to which pitches should change based on the value of 'density'
     // The density slider's center and right half indicate full pitch change range
     // The further the slider is to the left of the centerpoint, the less pitches should change
-    int get_pitch_change_density()
+    int get_pitch_change_density(uint8_t dens)
     {
       // Smaller values indicate fewer pitches should be drawn from
-      return constrain(density, 0,8);  // Note that the right half of the slider is clamped to full range
+      return constrain(dens, 0,8);  // Note that the right half of the slider is clamped to full range
     }
  
     bool step_is_gated(int step_num) {
-        return (gates & (0x01 << step_num));
+        return (patterns[play_pattern].gates & (0x01 << step_num));
     }
     
     bool step_is_slid(int step_num) {
-        return (slides & (0x01 << step_num));
+        return (patterns[play_pattern].slides & (0x01 << step_num));
     }
     
     bool step_is_accent(int step_num) {
-        return (accents & (0x01 << step_num));
+        return (patterns[play_pattern].accents & (0x01 << step_num));
     }
 
     bool step_is_oct_up(int step_num){
-       return (oct_ups & (0x01 << step_num));
+       return (patterns[play_pattern].oct_ups & (0x01 << step_num));
     }
     
     bool step_is_oct_down(int step_num){
-       return (oct_downs & (0x01 << step_num));
+       return (patterns[play_pattern].oct_downs & (0x01 << step_num));
     }
 
   	int get_next_step(int step_num)
@@ -764,9 +931,36 @@ class TB_3PO : public HemisphereApplet
     // Pass in a probability 0-100 to get that % chance to return 1
   	int rand_bit(int prob)
   	{
-  		return (random(1, 100) <= prob) ? 1 : 0;
+  		return (rand_range(99) + 1 <= prob) ? 1 : 0;  // 1-99, as Arduino's random(1, 100) did
   	}
 
+    // Per-instance xorshift32 generator, so the pattern for a seed is the same regardless of
+    // firmware build or what the other hemisphere is doing with Arduino's random()
+    void rand_seed(uint32_t s)
+    {
+      // Scramble the small seed values (murmur3 finalizer), xorshift needs a well mixed non-zero state
+      s ^= s >> 16;
+      s *= 0x85ebca6b;
+      s ^= s >> 13;
+      s *= 0xc2b2ae35;
+      s ^= s >> 16;
+      rng_state = s ? s : 0x2545f491;
+    }
+
+    uint32_t rand_next()
+    {
+      rng_state ^= rng_state << 13;
+      rng_state ^= rng_state >> 17;
+      rng_state ^= rng_state << 5;
+      return rng_state;
+    }
+
+    // Random value in the range 0 to max-1
+    int rand_range(int max)
+    {
+      return int((uint64_t(rand_next()) * uint32_t(max)) >> 32);
+    }
+
 
     void set_quantizer_scale(int new_scale)
     {
@@ -819,11 +1013,21 @@ class TB_3PO : public HemisphereApplet
           gfxPrint(static_cast<const char*>(sz));
         }
       }
+
+      // Bank slot, blinking until a recalled pattern starts playing
+      if(recall_phase == 0 || CursorBlink())
+      {
+        gfxPrint(57, 15, recall_slot + 1);
+      }
+      if(bank_cv)
+      {
+        gfxInvert(56, 14, 7, 9);  // Slot is selected by cv2
+      }
   
       // Display density 
         
-      int gate_dens = get_on_off_density();
-      int pitch_dens = get_pitch_change_density();
+      int gate_dens = get_on_off_density(density);
+      int pitch_dens = get_pitch_change_density(density);
 
       //gfxLine(9,36, 29, 36, true); // dotted line
       int xd = 5 + 7-gate_dens;
@@ -982,6 +1186,10 @@ class TB_3PO : public HemisphereApplet
       {
         gfxCursor(20, 54, 12);  // step
       }
+      else if(cursor == 9)
+      {
+        gfxCursor(56, 23, 7);  // bank slot
+      }
     }
 
 };
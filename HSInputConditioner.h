@@ -0,0 +1,129 @@
+// Copyright (c) 2018, Jason Justian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The input conditioner processes the four CV inputs once per ISR cycle, before
+// the applets' controllers are run, so that applets can read the conditioned
+// values without each of them filtering the same inputs again. Every stage is
+// off by default, in which case the applets see the raw pitch value.
+//
+// Stages, in processing order:
+//   - Median of three: rejects single-sample spikes
+//   - One-pole lowpass: smoothing by a power-of-two coefficient
+//   - Slew limiter: maximum change per tick
+//   - Hysteresis: the value only follows the input once it leaves a band
+
+#ifndef INPUT_CONDITIONER_H
+#define INPUT_CONDITIONER_H
+
+#define INPUT_CONDITIONER_SMOOTH_BITS 8
+
+class InputConditioner {
+public:
+    struct Config {
+        bool reject_spikes; // Median-of-three filter
+        uint8_t smoothing; // One-pole coefficient as 2^-smoothing, 0 is off
+        int slew_limit; // Maximum change per tick, 0 is off
+        int hysteresis; // Half-width of the hysteresis band, 0 is off
+    };
+
+    static InputConditioner *get() {
+        if (!instance) instance = new InputConditioner;
+        return instance;
+    }
+
+    void Configure(ADC_CHANNEL channel, const Config &config) {
+        configs[channel] = config;
+    }
+
+    const Config& GetConfig(ADC_CHANNEL channel) {return configs[channel];}
+
+    /* Called once per ISR cycle by the Hemisphere Manager */
+    void Process() {
+        for (int ch = 0; ch < ADC_CHANNEL_LAST; ch++)
+        {
+            int cv = OC::ADC::raw_pitch_value((ADC_CHANNEL)ch);
+            const Config &config = configs[ch];
+
+            if (config.reject_spikes) {
+                history[ch][0] = history[ch][1];
+                history[ch][1] = history[ch][2];
+                history[ch][2] = cv;
+                cv = Median(history[ch][0], history[ch][1], history[ch][2]);
+            }
+
+            if (config.smoothing) {
+                // cv can be negative, so it's scaled up by a multiply rather than a shift
+                smoothed[ch] += (cv * (1 << INPUT_CONDITIONER_SMOOTH_BITS) - smoothed[ch]) >> config.smoothing;
+                cv = smoothed[ch] >> INPUT_CONDITIONER_SMOOTH_BITS;
+            } else smoothed[ch] = cv * (1 << INPUT_CONDITIONER_SMOOTH_BITS);
+
+            if (config.slew_limit) {
+                cv = constrain(cv, values[ch] - config.slew_limit, values[ch] + config.slew_limit);
+            }
+
+            if (config.hysteresis) {
+                if (cv > values[ch] + config.hysteresis) cv -= config.hysteresis;
+                else if (cv < values[ch] - config.hysteresis) cv += config.hysteresis;
+                else cv = values[ch];
+            }
+
+            values[ch] = cv;
+
+            if (abs(cv - last_cv[ch]) > HEMISPHERE_CHANGE_THRESHOLD) {
+                changed[ch] = 1;
+                last_cv[ch] = cv;
+            } else changed[ch] = 0;
+        }
+    }
+
+    int Value(ADC_CHANNEL channel) {return values[channel];}
+
+    /* Has the input changed by more than 1/8 semitone since the last change? */
+    bool Changed(ADC_CHANNEL channel) {return changed[channel];}
+
+private:
+    static InputConditioner *instance;
+    Config configs[ADC_CHANNEL_LAST];
+    int history[ADC_CHANNEL_LAST][3];
+    int32_t smoothed[ADC_CHANNEL_LAST];
+    int values[ADC_CHANNEL_LAST];
+    int last_cv[ADC_CHANNEL_LAST];
+    bool changed[ADC_CHANNEL_LAST];
+
+    InputConditioner() {
+        for (int ch = 0; ch < ADC_CHANNEL_LAST; ch++)
+        {
+            configs[ch] = {0, 0, 0, 0};
+            for (int i = 0; i < 3; i++) history[ch][i] = 0;
+            smoothed[ch] = 0;
+            values[ch] = 0;
+            last_cv[ch] = 0;
+            changed[ch] = 0;
+        }
+    }
+
+    static int Median(int a, int b, int c) {
+        return max(min(a, b), min(max(a, b), c));
+    }
+};
+
+InputConditioner *InputConditioner::instance = 0;
+
+#endif // INPUT_CONDITIONER_H
@@ -40,6 +40,8 @@
 #define HEMISPHERE_HELP_OUTS 2
 #define HEMISPHERE_HELP_ENCODER 3
 
+#include "HSInputConditioner.h"
+
 // Simulated fixed floats by multiplying and dividing by powers of 2
 #ifndef int2simfloat
 #define int2simfloat(x) (x << 14)
@@ -95,22 +97,25 @@ public:
         // Maintain previous app state by skipping Start
         if (!applet_started) {
             applet_started = true;
+            ForEachChannel(ch) input_config[ch] = {0, 0, 0, 0};
             Start();
         }
+
+        // The conditioner is shared with whatever ran in this hemisphere before, so
+        // it gets this applet's settings back even when Start was skipped
+        ForEachChannel(ch) input_c->Configure((ADC_CHANNEL)(ch + io_offset), input_config[ch]);
     }
 
     void BaseController(bool master_clock_on) {
         master_clock_bus = (master_clock_on && hemisphere == RIGHT_HEMISPHERE);
         ForEachChannel(ch)
         {
-            // Set CV inputs
+            // Set CV inputs from the shared conditioning stage, which has already
+            // been run for this ISR cycle by the manager
 
             ADC_CHANNEL channel = (ADC_CHANNEL)(ch + io_offset);
-            inputs[ch] = OC::ADC::raw_pitch_value(channel);
-            if (abs(inputs[ch] - last_cv[ch]) > HEMISPHERE_CHANGE_THRESHOLD) {
-                changed_cv[ch] = 1;
-                last_cv[ch] = inputs[ch];
-            } else changed_cv[ch] = 0;
+            inputs[ch] = input_c->Value(channel);
+            changed_cv[ch] = input_c->Changed(channel);
 
             // Handle clock timing
             if (clock_countdown[ch] > 0) {
@@ -347,6 +352,23 @@ public:
         return clocked;
     }
 
+    /*
+     * Cycle counter timestamp of the most recent physical clock on the specified Digital
+     * input, with sub-tick resolution. Intervals between two of them are in units of
+     * F_CPU, e.g. 120 cycles per microsecond.
+     */
+    uint32_t ClockCycles(int ch) {
+        uint32_t cycles = 0;
+        if (hemisphere == 0) {
+            if (ch == 0) cycles = OC::DigitalInputs::clocked_cycles<OC::DIGITAL_INPUT_1>();
+            if (ch == 1) cycles = OC::DigitalInputs::clocked_cycles<OC::DIGITAL_INPUT_2>();
+        } else if (hemisphere == 1) {
+            if (ch == 0) cycles = OC::DigitalInputs::clocked_cycles<OC::DIGITAL_INPUT_3>();
+            if (ch == 1) cycles = OC::DigitalInputs::clocked_cycles<OC::DIGITAL_INPUT_4>();
+        }
+        return cycles;
+    }
+
     void ClockOut(int ch, int ticks = HEMISPHERE_CLOCK_TICKS) {
         clock_countdown[ch] = ticks;
         Out(ch, 0, 5);
@@ -451,6 +473,17 @@ protected:
         return (--adc_lag_countdown[ch] == 0);
     }
 
+    /* Select the conditioning applied to a CV input. The setting is shared by anything reading
+     * the same physical input, so it's usually done in Start(). Inputs are unconditioned until
+     * an applet asks otherwise, and the setting is restored whenever the applet is selected.
+     *
+     * ConfigureInput(0, {1, 3, 0, 16}); // Spike rejection, smoothing 1/8, no slew limit, hysteresis 16
+     */
+    void ConfigureInput(int ch, const InputConditioner::Config &config) {
+        input_config[ch] = config;
+        input_c->Configure((ADC_CHANNEL)(ch + io_offset), config);
+    }
+
     /* Master Clock Forwarding is activated. This is updated with each ISR cycle by the Hemisphere Manager */
     bool MasterClockForwarded() {return master_clock_bus;}
 
@@ -469,5 +502,6 @@ private:
     int last_view_tick; // Tick number of the most recent view
     int help_active;
     bool changed_cv[2]; // Has the input changed by more than 1/8 semitone since the last read?
-    int last_cv[2]; // For change detection
+    InputConditioner::Config input_config[2]; // Conditioning requested by the applet, see ConfigureInput()
+    InputConditioner *input_c = input_c->get();
 };
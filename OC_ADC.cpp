@@ -3,6 +3,10 @@
 
 #include <algorithm>
 
+#ifdef OC_ADC_ENABLE_DMA
+#include <DMAChannel.h>
+#endif
+
 namespace OC {
 
 template <ADC_CHANNEL> struct ChannelDesc { };
@@ -28,6 +32,24 @@ template <> struct ChannelDesc<ADC_CHANNEL_4> {
 /*static*/ volatile uint32_t ADC::busy_waits_;
 #endif
 
+#ifdef OC_ADC_ENABLE_DMA
+/*static*/ volatile uint16_t ADC::decimated_[ADC_CHANNEL_LAST];
+
+// dma_result moves each conversion into the ring buffer. Every completed
+// transfer is linked to dma_mux, which writes the SC1A word of the next
+// channel and thereby starts the next conversion, so the scan runs without
+// any CPU involvement. The buffer is split in two halves that are decimated
+// alternately, so the ISR never reads samples the DMA is still writing.
+static DMAChannel dma_result;
+static DMAChannel dma_mux;
+
+// Both buffers are used with the DMA modulo feature and need natural alignment
+static volatile uint16_t __attribute__((aligned(ADC::kAdcDmaBufferSize * sizeof(uint16_t))))
+  dma_buffer[ADC::kAdcDmaBufferSize];
+static volatile uint32_t __attribute__((aligned(ADC_CHANNEL_LAST * sizeof(uint32_t))))
+  dma_sc1a[ADC_CHANNEL_LAST];
+#endif
+
 /*static*/ void ADC::Init(CalibrationData *calibration_data) {
 
   // According to Paul Stoffregen: You do NOT want to have the pin in digital mode when using it as analog input.
@@ -41,28 +63,115 @@ template <> struct ChannelDesc<ADC_CHANNEL_4> {
   adc_.setResolution(kAdcScanResolution);
   adc_.setConversionSpeed(kAdcConversionSpeed);
   adc_.setSamplingSpeed(kAdcSamplingSpeed);
+#ifdef OC_ADC_ENABLE_DMA
+  adc_.setAveraging(kAdcDmaScanAverages);
+#else
   adc_.setAveraging(kAdcScanAverages);
+#endif
   adc_.disableDMA();
   adc_.disableInterrupts();
   adc_.disableCompare();
 
-  scan_channel_ = ADC_CHANNEL_1;
-  adc_.startSingleRead(ChannelDesc<ADC_CHANNEL_1>::PIN);
-
   calibration_data_ = calibration_data;
   std::fill(raw_, raw_ + ADC_CHANNEL_LAST, 0);
   std::fill(smoothed_, smoothed_ + ADC_CHANNEL_LAST, 0);
 #ifdef ENABLE_ADC_DEBUG
   busy_waits_ = 0;
 #endif
+
+#ifdef OC_ADC_ENABLE_DMA
+  Init_DMA();
+#else
+  scan_channel_ = ADC_CHANNEL_1;
+  adc_.startSingleRead(ChannelDesc<ADC_CHANNEL_1>::PIN);
+#endif
 }
 
+#ifdef OC_ADC_ENABLE_DMA
+/*static*/ void ADC::Init_DMA() {
+
+  static const uint8_t pins[ADC_CHANNEL_LAST] = {
+    ChannelDesc<ADC_CHANNEL_1>::PIN,
+    ChannelDesc<ADC_CHANNEL_2>::PIN,
+    ChannelDesc<ADC_CHANNEL_3>::PIN,
+    ChannelDesc<ADC_CHANNEL_4>::PIN,
+  };
+
+  // Let the driver translate each pin to its SC1A channel by running one
+  // blocking conversion per pin and reading back the register. The table is
+  // rotated by one since the DMA writes the *next* channel after a result.
+  for (size_t channel = ADC_CHANNEL_1; channel < ADC_CHANNEL_LAST; ++channel) {
+    adc_.startSingleRead(pins[channel], ADC_0);
+    while (!adc_.isComplete(ADC_0));
+    adc_.readSingle(ADC_0);
+    dma_sc1a[(channel + ADC_CHANNEL_LAST - 1) % ADC_CHANNEL_LAST] = ADC0_SC1A & ADC_SC1A_CHANNELS;
+  }
+  // All CV inputs are either on mux b or don't care, so it doesn't need to
+  // change during the scan
+  ADC0_CFG2 |= ADC_CFG2_MUXSEL;
+
+  std::fill(dma_buffer, dma_buffer + kAdcDmaBufferSize, 0);
+  std::fill(decimated_, decimated_ + ADC_CHANNEL_LAST, 0);
+
+  dma_result.source((volatile uint16_t&)ADC0_RA);
+  dma_result.destinationCircular(dma_buffer, sizeof(dma_buffer));
+  dma_result.triggerAtHardwareEvent(DMAMUX_SOURCE_ADC0);
+  dma_result.interruptAtHalf();
+  dma_result.interruptAtCompletion();
+  dma_result.attachInterrupt(DMA_ISR);
+
+  dma_mux.sourceCircular(dma_sc1a, sizeof(dma_sc1a));
+  dma_mux.destination(ADC0_SC1A);
+  // Minor loop linking is suppressed on the last transfer of the major loop,
+  // so both links are required to keep the chain running across passes.
+  dma_mux.triggerAtTransfersOf(dma_result);
+  dma_mux.triggerAtCompletionOf(dma_result);
+
+  dma_mux.enable();
+  dma_result.enable();
+  adc_.enableDMA(ADC_0);
+
+  // The first conversion is started manually, the DMA chain does the rest
+  adc_.startSingleRead(ChannelDesc<ADC_CHANNEL_1>::PIN, ADC_0);
+}
+
+/*static*/ void FASTRUN ADC::DMA_ISR() {
+  dma_result.clearInterrupt();
+
+  // Decimate the half the DMA has just left; if it's now writing into the
+  // first half, the second one is complete.
+  const volatile uint16_t *sample = dma_buffer;
+  if ((const volatile uint16_t *)dma_result.destinationAddress() < dma_buffer + kAdcDmaHalfSize)
+    sample += kAdcDmaHalfSize;
+
+  // Samples are interleaved by channel; average each channel's
+  // kAdcDmaOversampling values.
+  uint32_t sum[ADC_CHANNEL_LAST] = { 0 };
+  for (size_t i = 0; i < kAdcDmaOversampling; ++i) {
+    sum[ADC_CHANNEL_1] += *sample++;
+    sum[ADC_CHANNEL_2] += *sample++;
+    sum[ADC_CHANNEL_3] += *sample++;
+    sum[ADC_CHANNEL_4] += *sample++;
+  }
+
+  for (size_t channel = ADC_CHANNEL_1; channel < ADC_CHANNEL_LAST; ++channel)
+    decimated_[channel] = sum[channel] / kAdcDmaOversampling;
+}
+#endif
+
 // As I understand it, only CV4 can be muxed to ADC1, so it's not possible to
 // use ADC::startSynchronizedSingleRead, which would allow reading two channels
 // simultaneously
 
 /*static*/ void FASTRUN ADC::Scan() {
 
+#ifdef OC_ADC_ENABLE_DMA
+  update<ADC_CHANNEL_1>(decimated_[ADC_CHANNEL_1]);
+  update<ADC_CHANNEL_2>(decimated_[ADC_CHANNEL_2]);
+  update<ADC_CHANNEL_3>(decimated_[ADC_CHANNEL_3]);
+  update<ADC_CHANNEL_4>(decimated_[ADC_CHANNEL_4]);
+#else
+
 #ifdef ENABLE_ADC_DEBUG
   if (!adc_.isComplete(ADC_0)) {
     ++busy_waits_;
@@ -98,6 +207,7 @@ template <> struct ChannelDesc<ADC_CHANNEL_4> {
       break;
   }
   scan_channel_ = channel;
+#endif
 }
 
 /*static*/ void ADC::CalibratePitch(int32_t c2, int32_t c4) {
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include "src/drivers/ADC/OC_util_ADC.h"
 #include "OC_config.h"
+#include "OC_options.h"
 
 #include <stdint.h>
 #include <string.h>
@@ -37,6 +38,17 @@ public:
 
   static constexpr uint32_t kAdcValueShift = kAdcSmoothBits;
 
+#ifdef OC_ADC_ENABLE_DMA
+  // In DMA mode the ADC runs freely over all channels, so hardware averaging
+  // is traded for software oversampling: each half of the ring buffer holds
+  // kAdcDmaOversampling conversions per channel, which are decimated into a
+  // single value per channel once the DMA has moved on to the other half.
+  static constexpr uint8_t kAdcDmaScanAverages = 4;
+  static constexpr uint32_t kAdcDmaOversampling = 8; // must be power-of-two
+  static constexpr uint32_t kAdcDmaHalfSize = ADC_CHANNEL_LAST * kAdcDmaOversampling;
+  static constexpr uint32_t kAdcDmaBufferSize = 2 * kAdcDmaHalfSize;
+#endif
+
 
   struct CalibrationData {
     uint16_t offset[ADC_CHANNEL_LAST];
@@ -48,9 +60,9 @@ public:
 
   // Read the value of the last conversion and update current channel, then
   // start the next conversion. If necessary, some channels could be given
-  // priority by scanning them more often. Even better might be some kind of
-  // continuous/DMA sampling to make things even more independent of the main
-  // ISR timing restrictions.
+  // priority by scanning them more often.
+  // With OC_ADC_ENABLE_DMA, conversions are chained by DMA independently of
+  // the main ISR and Scan only picks up the latest decimated values.
   static void Scan();
 
   template <ADC_CHANNEL channel>
@@ -96,6 +108,11 @@ public:
 
   static void CalibratePitch(int32_t c2, int32_t c4);
 
+#ifdef OC_ADC_ENABLE_DMA
+  // Called from DMA ISR when either half of the ring buffer is complete
+  static void DMA_ISR();
+#endif
+
 private:
 
   template <ADC_CHANNEL channel>
@@ -114,6 +131,12 @@ private:
   static uint32_t raw_[ADC_CHANNEL_LAST];
   static uint32_t smoothed_[ADC_CHANNEL_LAST];
 
+#ifdef OC_ADC_ENABLE_DMA
+  static void Init_DMA();
+
+  static volatile uint16_t decimated_[ADC_CHANNEL_LAST];
+#endif
+
 #ifdef ENABLE_ADC_DEBUG
   static volatile uint32_t busy_waits_;
 #endif
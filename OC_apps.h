@@ -72,6 +72,15 @@ namespace apps {
 
   void Init(bool reset_settings);
 
+  // Do a step of pending app data storage compaction, if any
+  void CompactStorage();
+
+  // Extra chunks in the app data journal, for state that doesn't fit in an
+  // app's settings (e.g. applet banks). Ids must not clash with app ids, and
+  // these are only to be called from the main loop.
+  bool ReadChunk(uint16_t id, void *data, size_t length);
+  bool WriteChunk(uint16_t id, const void *data, size_t length);
+
   inline void ISR() __attribute__((always_inline));
   inline void ISR() {
     if (current_app && current_app->isr)
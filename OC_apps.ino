@@ -23,6 +23,7 @@
 #include "OC_apps.h"
 #include "OC_digital_inputs.h"
 #include "OC_autotune.h"
+#include "util/util_journalstorage.h"
 
 #define DECLARE_APP(a, b, name, prefix) \
 { TWOCC<a,b>::value, name, \
@@ -39,6 +40,7 @@ OC::App available_apps[] = {
   DECLARE_APP('M','I', "Captain Midi", MIDI),
   DECLARE_APP('S','C', "Scale Editor", SCALEEDITOR),
   DECLARE_APP('C','S', "CV Scaler", CVScaler),
+  DECLARE_APP('G','R', "Grids", GridsKit),
   DECLARE_APP('W','A', "Waveform Editor", WaveformEditor),
   DECLARE_APP('B','R', "Backup / Restore", Backup),
   DECLARE_APP('S','E', "Setup / About", Settings),
@@ -46,6 +48,9 @@ OC::App available_apps[] = {
 
 static constexpr int NUM_AVAILABLE_APPS = ARRAY_SIZE(available_apps);
 
+// Journal chunks besides the apps' own, see apps::WriteChunk
+static constexpr int NUM_EXTRA_CHUNKS = 2; // TB-3PO banks, one per hemisphere
+
 namespace OC {
 
 // Global settings are stored separately to actual app setings.
@@ -65,26 +70,36 @@ struct GlobalSettings {
   OC::Autotune_data auto_calibration_data[DAC_CHANNEL_LAST];
 };
 
-// App settings are packed into a single blob of binary data; each app's chunk
-// gets its own header with id and the length of the entire chunk. This makes
-// this a bit more flexible during development.
-// Chunks are aligned on 2-byte boundaries for arbitrary reasons (thankfully M4
-// allows unaligned access...)
+// App settings are stored in a journal, with one chunk per app identified by
+// the app id. Saving only appends the chunks that have actually changed, and
+// the journal is compacted in small steps from the main loop; so saving no
+// longer rewrites the entire blob and the writes are spread across the EEPROM.
+struct AppData {
+  static constexpr uint32_t FOURCC = FOURCC<'O','C','A',5>::value;
+
+  static constexpr size_t kAppDataSize = EEPROM_APPDATA_BINARY_SIZE;
+  char data[kAppDataSize]; // Scratch buffer for serializing a single app
+};
+
+// Layout of the app settings before the journal: a single page holding the
+// chunks of all apps, each with its own header giving the id and the length
+// of the entire chunk (aligned on 2 bytes). Only read once to carry the
+// settings over, see migrate_legacy_app_data.
 struct AppChunkHeader {
   uint16_t id;
   uint16_t length;
 } __attribute__((packed));
 
-struct AppData {
+struct LegacyAppData {
   static constexpr uint32_t FOURCC = FOURCC<'O','C','A',4>::value;
 
-  static constexpr size_t kAppDataSize = EEPROM_APPDATA_BINARY_SIZE;
-  char data[kAppDataSize];
+  char data[EEPROM_APPDATA_BINARY_SIZE];
   size_t used;
 };
 
 typedef PageStorage<EEPROMStorage, EEPROM_GLOBALSETTINGS_START, EEPROM_GLOBALSETTINGS_END, GlobalSettings> GlobalSettingsStorage;
-typedef PageStorage<EEPROMStorage, EEPROM_APPDATA_START, EEPROM_APPDATA_END, AppData> AppDataStorage;
+typedef JournalStorage<EEPROMStorage, EEPROM_APPDATA_START, EEPROM_APPDATA_END, AppData::FOURCC, NUM_AVAILABLE_APPS + NUM_EXTRA_CHUNKS> AppDataStorage;
+typedef PageStorage<EEPROMStorage, EEPROM_APPDATA_START, EEPROM_APPDATA_END, LegacyAppData> LegacyAppDataStorage;
 
 GlobalSettings global_settings;
 GlobalSettingsStorage global_settings_storage;
@@ -110,82 +125,91 @@ void save_global_settings() {
 }
 
 void save_app_data() {
-  SERIAL_PRINTLN("Save app data... (%u bytes available)", OC::AppData::kAppDataSize);
-
-  app_settings.used = 0;
-  char *data = app_settings.data;
-  char *data_end = data + OC::AppData::kAppDataSize;
-
-  size_t start_app = random(NUM_AVAILABLE_APPS);
-  for (size_t i = 0; i < NUM_AVAILABLE_APPS; ++i) {
-    const auto &app = available_apps[(start_app + i) % NUM_AVAILABLE_APPS];
-    size_t storage_size = app.storageSize() + sizeof(AppChunkHeader);
-    if (storage_size & 1) ++storage_size; // Align chunks on 2-byte boundaries
-    if (storage_size > sizeof(AppChunkHeader) && app.Save) {
-      if (data + storage_size > data_end) {
-        SERIAL_PRINTLN("%s: ERROR: %u BYTES NEEDED, %u BYTES AVAILABLE OF %u BYTES TOTAL", app.name, storage_size, data_end - data, AppData::kAppDataSize);
-        continue;
-      }
+  SERIAL_PRINTLN("Save app data... (%u bytes available in bank %d)", app_data_storage.available(), app_data_storage.bank_index());
 
-      AppChunkHeader *chunk = reinterpret_cast<AppChunkHeader *>(data);
-      chunk->id = app.id;
-      chunk->length = storage_size;
-      #ifdef PRINT_DEBUG
-        SERIAL_PRINTLN("* %s (%02x) : Saved %u bytes... (%u)", app.name, app.id, app.Save(chunk + 1), storage_size);
-      #else
-        app.Save(chunk + 1);
-      #endif
-      app_settings.used += chunk->length;
-      data += chunk->length;
+  for (const auto &app : available_apps) {
+    size_t storage_size = app.storageSize();
+    if (!storage_size || !app.Save)
+      continue;
+    if (storage_size > AppData::kAppDataSize) {
+      SERIAL_PRINTLN("%s: ERROR: %u BYTES NEEDED, %u BYTES AVAILABLE", app.name, storage_size, AppData::kAppDataSize);
+      continue;
+    }
+
+    app.Save(app_settings.data);
+    if (app_data_storage.Write(app.id, app_settings.data, storage_size)) {
+      SERIAL_PRINTLN("* %s (%02x) : Saved %u bytes", app.name, app.id, storage_size);
+    } else {
+      SERIAL_PRINTLN("* %s (%02x) : Unchanged or not saved", app.name, app.id);
     }
   }
-  SERIAL_PRINTLN("App settings used: %u/%u", app_settings.used, EEPROM_APPDATA_BINARY_SIZE);
-  app_data_storage.Save(app_settings);
-  SERIAL_PRINTLN("Saved app settings in page_index %d", app_data_storage.page_index());
+  SERIAL_PRINTLN("Saved app settings in bank %d, %u bytes available", app_data_storage.bank_index(), app_data_storage.available());
 }
 
 void restore_app_data() {
-  SERIAL_PRINTLN("Restoring app data from page_index %d, used=%u", app_data_storage.page_index(), app_settings.used);
+  SERIAL_PRINTLN("Restoring app data from bank %d", app_data_storage.bank_index());
 
-  const char *data = app_settings.data;
-  const char *data_end = data + app_settings.used;
   size_t restored_bytes = 0;
+  for (const auto &app : available_apps) {
+    size_t storage_size = app.storageSize();
+    if (!storage_size || !app.Restore || storage_size > AppData::kAppDataSize)
+      continue;
 
-  while (data < data_end) {
-    const AppChunkHeader *chunk = reinterpret_cast<const AppChunkHeader *>(data);
-    if (data + chunk->length > data_end) {
-      SERIAL_PRINTLN("App chunk length %u exceeds available space (%u)", chunk->length, data_end - data);
-      break;
-    }
-
-    App *app = apps::find(chunk->id);
-    if (!app) {
-      SERIAL_PRINTLN("App %02x not found, ignoring chunk...", app->id);
-      if (!chunk->length)
-        break;
-      data += chunk->length;
+    if (!app_data_storage.Read(app.id, app_settings.data, storage_size)) {
+      SERIAL_PRINTLN("* %s (%02x): no data with storageSize=%u, skipping...", app.name, app.id, storage_size);
       continue;
     }
-    size_t expected_length = app->storageSize() + sizeof(AppChunkHeader);
-    if (expected_length & 0x1) ++expected_length;
-    if (chunk->length != expected_length) {
-      SERIAL_PRINTLN("* %s (%02x): chunk length %u != %u (storageSize=%u), skipping...", app->name, chunk->id, chunk->length, expected_length, app->storageSize());
-      data += chunk->length;
-      continue;
+
+    #ifdef PRINT_DEBUG
+      SERIAL_PRINTLN("* %s (%02x): Restored %u from %u...", app.name, app.id, app.Restore(app_settings.data), storage_size);
+    #else
+      app.Restore(app_settings.data);
+    #endif
+    restored_bytes += storage_size;
+  }
+
+  SERIAL_PRINTLN("App data restored: %u", restored_bytes);
+}
+
+// Journal the app chunks of the legacy single page layout, if there is one.
+// Both layouts share the EEPROM area and the first journal write overwrites
+// the page, so it is read in full first. This only runs once, at the first
+// boot without a journal, so the buffers are on the stack.
+bool migrate_legacy_app_data() {
+  LegacyAppDataStorage legacy_storage;
+  LegacyAppData legacy;
+  if (!legacy_storage.Load(legacy))
+    return false;
+
+  SERIAL_PRINTLN("Migrating legacy app data, used=%u", legacy.used);
+  app_data_storage.Init();
+
+  const char *data = legacy.data;
+  const char *data_end = data + std::min(legacy.used, sizeof(legacy.data));
+  size_t migrated = 0;
+  while (data + sizeof(AppChunkHeader) <= data_end) {
+    const AppChunkHeader *chunk = reinterpret_cast<const AppChunkHeader *>(data);
+    if (chunk->length < sizeof(AppChunkHeader) || data + chunk->length > data_end) {
+      SERIAL_PRINTLN("Legacy chunk length %u is invalid, stopping", chunk->length);
+      break;
     }
 
-    if (app->Restore) {
-      #ifdef PRINT_DEBUG
-        SERIAL_PRINTLN("* %s (%02x): Restored %u from %u (chunk length %u)...", app->name, chunk->id, app->Restore(chunk + 1), chunk->length - sizeof(AppChunkHeader), chunk->length);
-      #else
-        app->Restore(chunk + 1);
-      #endif
+    const App *app = apps::find(chunk->id);
+    if (app) {
+      const size_t storage_size = app->storageSize();
+      size_t expected_length = storage_size + sizeof(AppChunkHeader);
+      if (expected_length & 0x1) ++expected_length;
+      if (chunk->length == expected_length && app_data_storage.Write(chunk->id, chunk + 1, storage_size)) {
+        SERIAL_PRINTLN("* %s (%02x): Migrated %u bytes", app->name, app->id, storage_size);
+        ++migrated;
+      } else {
+        SERIAL_PRINTLN("* %s (%02x): chunk length %u != %u, skipping...", app->name, chunk->id, chunk->length, expected_length);
+      }
     }
-    restored_bytes += chunk->length;
     data += chunk->length;
   }
 
-  SERIAL_PRINTLN("App data restored: %u, expected %u", restored_bytes, app_settings.used);
+  return migrated > 0;
 }
 
 namespace apps {
@@ -261,16 +285,15 @@ void Init(bool reset_settings) {
       DAC::restore_scaling(global_settings.DAC_scaling); // recover output scaling settings
     }
 
-    SERIAL_PRINTLN("Load app data: size is %u, PAGESIZE=%u, PAGES=%u, LENGTH=%u",
-                  sizeof(AppData),
-                  AppDataStorage::PAGESIZE,
-                  AppDataStorage::PAGES,
+    SERIAL_PRINTLN("Load app data: BANKSIZE=%u, BANKS=%u, LENGTH=%u",
+                  AppDataStorage::BANKSIZE,
+                  AppDataStorage::BANKS,
                   AppDataStorage::LENGTH);
 
-    if (!app_data_storage.Load(app_settings)) {
-      SERIAL_PRINTLN("Data not loaded, using defaults!");
-    } else {
+    if (app_data_storage.Load() || migrate_legacy_app_data()) {
       restore_app_data();
+    } else {
+      SERIAL_PRINTLN("Data not loaded, using defaults!");
     }
   }
 
@@ -290,6 +313,18 @@ void Init(bool reset_settings) {
   delay(100);
 }
 
+void CompactStorage() {
+  app_data_storage.Compact();
+}
+
+bool ReadChunk(uint16_t id, void *data, size_t length) {
+  return app_data_storage.Read(id, data, length);
+}
+
+bool WriteChunk(uint16_t id, const void *data, size_t length) {
+  return app_data_storage.Write(id, data, length);
+}
+
 }; // namespace apps
 
 void draw_app_menu(const menu::ScreenCursor<5> &cursor) {
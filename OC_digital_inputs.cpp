@@ -10,6 +10,12 @@ uint32_t OC::DigitalInputs::clocked_mask_;
 /*static*/
 volatile uint32_t OC::DigitalInputs::clocked_[DIGITAL_INPUT_LAST];
 
+/*static*/
+volatile uint32_t OC::DigitalInputs::clocked_cycles_[DIGITAL_INPUT_LAST];
+
+/*static*/
+uint32_t OC::DigitalInputs::edge_cycles_[DIGITAL_INPUT_LAST];
+
 void FASTRUN tr1_ISR() {  
   OC::DigitalInputs::clock<OC::DIGITAL_INPUT_1>();
 }  // main clock
@@ -46,11 +52,18 @@ void OC::DigitalInputs::Init() {
 
   clocked_mask_ = 0;
   std::fill(clocked_, clocked_ + DIGITAL_INPUT_LAST, 0);
+  std::fill(clocked_cycles_, clocked_cycles_ + DIGITAL_INPUT_LAST, 0);
+  std::fill(edge_cycles_, edge_cycles_ + DIGITAL_INPUT_LAST, 0);
+
+  // Edge timestamps use the cycle counter; this is normally already enabled
+  // by OC::DEBUG::Init but doesn't hurt to make sure.
+  ARM_DEMCR |= ARM_DEMCR_TRCENA;
+  ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
 
   // Assume the priority of pin change interrupts is lower or equal to the
   // thread where ::Scan function is called. Otherwise a safer mechanism is
-  // required to avoid conflicts (LDREX/STREX or store ARM_DWT_CYCCNT in the
-  // array to check for changes.
+  // required to avoid conflicts (LDREX/STREX or check the stored
+  // ARM_DWT_CYCCNT in clocked_cycles_ for changes).
   //
   // A really nice approach would be to use the FTM timer mechanism and avoid
   // the ISR altogether, but this only works for one of the pins. Using more
@@ -61,7 +61,19 @@ public:
     return !digitalReadFast(InputPinMap(input));
   }
 
+  // @return cycle counter (ARM_DWT_CYCCNT) at the edge of the most recent
+  // clock, i.e. sub-tick timestamp of the last time clocked() was set. At
+  // F_CPU the counter wraps every ~35s, so differences are valid below that.
+  template <DigitalInput input> static inline uint32_t clocked_cycles() {
+    return edge_cycles_[input];
+  }
+
+  static inline uint32_t clocked_cycles(DigitalInput input) {
+    return edge_cycles_[input];
+  }
+
   template <DigitalInput input> static inline void clock() {
+    clocked_cycles_[input] = ARM_DWT_CYCCNT;
     clocked_[input] = 1;
   }
 
@@ -80,11 +92,14 @@ private:
 
   static uint32_t clocked_mask_;
   static volatile uint32_t clocked_[DIGITAL_INPUT_LAST];
+  static volatile uint32_t clocked_cycles_[DIGITAL_INPUT_LAST];
+  static uint32_t edge_cycles_[DIGITAL_INPUT_LAST];
 
   template <DigitalInput input>
   static uint32_t ScanInput() {
     if (clocked_[input]) {
       clocked_[input] = 0;
+      edge_cycles_[input] = clocked_cycles_[input];
       return DIGITAL_INPUT_MASK(input);
     } else {
       return 0;
@@ -21,6 +21,8 @@
 //#define INVERT_DISPLAY
 /* ------------ use DAC8564 -------------------------------------------------------------------------  */
 //#define DAC8564
+/* ------------ continuous DMA-driven ADC scan over all CV inputs ----------------------------------  */
+//#define OC_ADC_ENABLE_DMA
 
 #endif
 
@@ -287,6 +287,15 @@ static inline int32_t multiply_16tx16b_add_16bx16t(uint32_t a, uint32_t b)
 	return out;
 }
 
+// computes sum + ((a[15:0] * b[15:0]) + (a[31:16] * b[31:16])), 32 bit accumulator
+static inline int32_t multiply_accumulate_32_16tx16t_add_16bx16b(int32_t sum, uint32_t a, uint32_t b) __attribute__((always_inline, unused));
+static inline int32_t multiply_accumulate_32_16tx16t_add_16bx16b(int32_t sum, uint32_t a, uint32_t b)
+{
+	int32_t out;
+	asm volatile("smlad %0, %1, %2, %3" : "=r" (out) : "r" (a), "r" (b), "r" (sum));
+	return out;
+}
+
 // // computes sum += ((a[15:0] * b[15:0]) + (a[31:16] * b[31:16]))
 static inline int64_t multiply_accumulate_16tx16t_add_16bx16b(int64_t sum, uint32_t a, uint32_t b)
 {
@@ -337,6 +346,15 @@ static inline int32_t multiply_16tx16t(uint32_t a, uint32_t b)
 	return out;
 }
 
+// computes (a + b), result saturated to 32 bit integer range
+static inline int32_t add_32_saturate(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
+static inline int32_t add_32_saturate(uint32_t a, uint32_t b)
+{
+	int32_t out;
+	asm volatile("qadd %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
+	return out;
+}
+
 // computes (a - b), result saturated to 32 bit integer range
 static inline int32_t substract_32_saturate(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t substract_32_saturate(uint32_t a, uint32_t b)
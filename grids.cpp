@@ -1,10 +1,9 @@
 #include "grids.h"
+#include <atomic>
 #include <cmath>
 
 namespace grids
 {
-  const uint8_t kStepsPerPattern = 32;
-
   inline uint8_t U8Mix(uint8_t a, uint8_t b, uint8_t balance)
   {
     uint16_t mix = b * balance;
@@ -393,26 +392,129 @@ namespace grids
     return U8Mix(U8Mix(a, b, x << 2), U8Mix(c, d, x << 2), y << 2);
   }
 
-  Channel::Channel()
+  Map::Map() : x_(0), y_(0), valid_(false)
   {
   }
 
-  void Channel::reset()
+  void Map::invalidate()
+  {
+    valid_ = false;
+  }
+
+  void Map::update(uint8_t x, uint8_t y)
+  {
+    if (valid_ && x == x_ && y == y_)
+      return;
+
+    for (uint8_t part = 0; part < kNumParts; part++)
+    {
+      for (uint8_t step = 0; step < kStepsPerPattern; step++)
+      {
+        levels_[part][step] = ReadDrumMap(step, part, x, y);
+      }
+    }
+    x_ = x;
+    y_ = y;
+    valid_ = true;
+  }
+
+  BufferedMap::BufferedMap() : front_(0), x_(0), y_(0)
+  {
+    maps_[0].update(x_, y_);
+  }
+
+  void BufferedMap::update()
+  {
+    const uint8_t x = x_;
+    const uint8_t y = y_;
+    if (maps_[front_].at(x, y))
+      return;
+
+    maps_[front_ ^ 1].update(x, y);
+    // The table has to be complete before the ISR sees the swap
+    std::atomic_signal_fence(std::memory_order_release);
+    front_ ^= 1;
+  }
+
+  Kit::Kit() : step_(0), rng_(0x21)
+  {
+    for (uint8_t step = 0; step < kStepsPerPattern; step++)
+    {
+      for (uint8_t part = 0; part < kNumParts; part++)
+      {
+        perturbation_[step][part] = random();
+      }
+    }
+  }
+
+  void Kit::reset()
   {
     step_ = 0;
   }
 
-  void Channel::advance()
+  void Kit::seed(uint32_t seed)
   {
+    rng_ = seed ? seed : 0x21;
+    // The perturbations already drawn would replay the previous seed
+    for (uint8_t step = 0; step < kStepsPerPattern; step++)
+    {
+      for (uint8_t part = 0; part < kNumParts; part++)
+      {
+        perturbation_[step][part] = random();
+      }
+    }
+  }
+
+  uint8_t Kit::random()
+  {
+    // xorshift32
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return rng_ >> 24;
+  }
+
+  uint8_t Kit::process(const uint8_t* density, uint8_t chaos)
+  {
+    const Map& map = map_.front();
+
+    uint8_t state = 0;
+    for (uint8_t part = 0; part < kNumParts; part++)
+    {
+      uint8_t level = map.level(Selector(part), step_);
+      const uint8_t perturbation = (perturbation_[step_][part] * chaos) >> 8;
+      level = (level < 255 - perturbation) ? level + perturbation : 255;
+
+      const uint8_t threshold = ~density[part];
+      if (level > threshold)
+      {
+        state |= 1 << part;
+        if (level > kAccentThreshold)
+        {
+          state |= 1 << OUTPUT_ACCENT;
+        }
+      }
+
+      // Randomness for this step of the next cycle
+      perturbation_[step_][part] = random();
+    }
+
     step_ = (step_ + 1) % kStepsPerPattern;
+    return state;
   }
 
-  uint8_t Channel::level(Selector selector, uint16_t x, uint16_t y)
+  Channel::Channel()
   {
-    uint16_t xmap = x % 256;
-    uint16_t ymap = y % 256;
-    int part = int(selector) %3;
-    return ReadDrumMap(step_, part, xmap, ymap);
+  }
+
+  void Channel::reset()
+  {
+    step_ = 0;
+  }
+
+  void Channel::advance()
+  {
+    step_ = (step_ + 1) % kStepsPerPattern;
   }
 
   uint8_t Channel::step()
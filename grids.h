@@ -4,17 +4,139 @@
 
 namespace grids
 {
-  class Channel
+  const uint8_t kNumParts = 3;
+  const uint8_t kStepsPerPattern = 32;
+
+  enum class Selector
+  {
+    BD,
+    SD,
+    HH
+  };
+
+  // Interpolated levels of all parts and steps for a given map position.
+  // The table is only rebuilt when the position changes, so reading a level
+  // is a single lookup.
+  class Map
   {
   public:
+    Map();
+
+    void update(uint8_t x, uint8_t y);
+    void invalidate();
 
-    enum class Selector
+    // Is the table built for this position?
+    inline bool at(uint8_t x, uint8_t y) const
     {
-      BD,
-      SD,
-      HH
+      return valid_ && x == x_ && y == y_;
+    }
+
+    inline uint8_t level(Selector selector, uint8_t step) const
+    {
+      return levels_[int(selector)][step];
+    }
+
+  private:
+    uint8_t levels_[kNumParts][kStepsPerPattern];
+    uint8_t x_;
+    uint8_t y_;
+    bool valid_;
+  };
+
+  // A map shared between the ISR and the main loop: the ISR only requests a
+  // position, and update() rebuilds the back map from the main loop and
+  // swaps it in, so a moving X/Y never costs a full rebuild in the ISR.
+  class BufferedMap
+  {
+  public:
+    BufferedMap();
+
+    // Request a map position, picked up by the next update()
+    void setPosition(uint8_t x, uint8_t y)
+    {
+      x_ = x;
+      y_ = y;
+    }
+
+    // Rebuild the map if the requested position has changed; to be called
+    // from the main loop, not the ISR
+    void update();
+
+    inline const Map& front() const
+    {
+      return maps_[front_];
+    }
+
+  private:
+    Map maps_[2];
+    volatile uint8_t front_;
+    volatile uint8_t x_;
+    volatile uint8_t y_;
+  };
+
+  // Three parts with accents and chaos, in the style of the original Grids.
+  // All parts are evaluated from a single cached map per step. The random
+  // perturbation of each step is drawn one pattern cycle ahead, a few values
+  // per step, so the cost of a step doesn't depend on the chaos amount.
+  // The map is a BufferedMap, rebuilt from the main loop.
+  class Kit
+  {
+  public:
+
+    enum Output
+    {
+      OUTPUT_BD,
+      OUTPUT_SD,
+      OUTPUT_HH,
+      OUTPUT_ACCENT,
+      OUTPUT_COUNT
     };
 
+    static const uint8_t kAccentThreshold = 192;
+
+    Kit();
+
+    void reset();
+    // Restarts the chaos generator, also redrawing the pending perturbations
+    void seed(uint32_t seed);
+
+    // Request a map position, picked up by the next update()
+    void setPosition(uint8_t x, uint8_t y)
+    {
+      map_.setPosition(x, y);
+    }
+
+    // Rebuild the map if the requested position has changed; to be called
+    // from the main loop, not the ISR
+    void update()
+    {
+      map_.update();
+    }
+
+    // Evaluate the current step and advance; returns a bitmask of triggered
+    // outputs, i.e. (1 << OUTPUT_BD) etc.
+    uint8_t process(const uint8_t* density, uint8_t chaos);
+
+    uint8_t step() const
+    {
+      return step_;
+    }
+
+  private:
+    uint8_t random();
+
+    BufferedMap map_;
+    uint8_t step_;
+    uint8_t perturbation_[kStepsPerPattern][kNumParts];
+    uint32_t rng_;
+  };
+
+  class Channel
+  {
+  public:
+
+    using Selector = grids::Selector;
+
     Channel();
 
     void reset();
@@ -22,8 +144,6 @@ namespace grids
 
     uint8_t step();
 
-    uint8_t level(Selector selector, uint16_t x, uint16_t y);
-
   private:
     uint8_t step_;
   };
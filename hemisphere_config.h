@@ -8,7 +8,7 @@
 // 0x40 = Logic
 // 0x80 = Other
 
-#define HEMISPHERE_AVAILABLE_APPLETS 10
+#define HEMISPHERE_AVAILABLE_APPLETS 12
 
 //////////////////  id  cat   class name
 #define HEMISPHERE_APPLETS { \
@@ -22,5 +22,7 @@
     DECLARE_APPLET( 8, 0x04, FlipFlopPattern), \
     DECLARE_APPLET( 9, 0x4, TB_3PO), \
     DECLARE_APPLET(10, 0x4, Mimetic), \
+    DECLARE_APPLET(11, 0x01, DualADSR), \
+    DECLARE_APPLET(12, 0x01, PeaksEG), \
 }
 /*    DECLARE_APPLET(127, 0x80, DIAGNOSTIC), \ */
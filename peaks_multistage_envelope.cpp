@@ -36,6 +36,14 @@ namespace peaks {
 using namespace stmlib;
 
 void MultistageEnvelope::Init() {
+  // No segment time matches, so that all increments get cached
+  for (uint16_t segment = 0; segment < kMaxNumSegments; ++segment) {
+    time_[segment] = 0xffff;
+    time_multiplier_[segment] = 0xffff;
+  }
+  attack_multiplier_ = 0;
+  decay_multiplier_ = 0;
+  release_multiplier_ = 0;
   set_adsr(0, 8192, 16384, 32767);
   segment_ = num_segments_;
   phase_ = 0;
@@ -122,7 +130,7 @@ uint16_t MultistageEnvelope::ProcessSingleSample(uint8_t control) {
       control & CONTROL_GATE;
 
   phase_increment_ =
-      sustained || done ? 0 : lut_env_increments[time_[segment_] >> 8] >> time_multiplier_[segment_];
+      sustained || done ? 0 : phase_increments_[segment_];
 
   int32_t a = start_value_;
   int32_t b = level_[segment_ + 1];
@@ -33,6 +33,7 @@
 #include "util/util_macros.h"
 #include "OC_options.h"
 #include "peaks_gate_processor.h"
+#include "peaks_resources.h"
 
 namespace peaks {
 
@@ -96,11 +97,11 @@ class MultistageEnvelope {
   }
   
   inline void set_time(uint16_t segment, uint16_t time) {
-    time_[segment] = time;
+    set_segment_time(segment, time, time_multiplier_[segment]);
   }
 
   inline void set_time_multiplier(uint16_t segment, uint16_t time_multiplier) {
-    time_multiplier_[segment] = time_multiplier;
+    set_segment_time(segment, time_[segment], time_multiplier);
   }
   
   inline void set_level(uint16_t segment, int16_t level) {
@@ -129,18 +130,14 @@ class MultistageEnvelope {
     level_[2] = sustain;
     level_[3] = 0;
 
-    time_[0] = attack;
-    time_[1] = decay;
-    time_[2] = release;
+    set_segment_time(0, attack, attack_multiplier_);
+    set_segment_time(1, decay, decay_multiplier_);
+    set_segment_time(2, release, release_multiplier_);
     
     shape_[0] = attack_shape_;
     shape_[1] = decay_shape_;
     shape_[2] = release_shape_;
 
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
-    time_multiplier_[2] = release_multiplier_;
-
     loop_start_ = loop_end_ = 0;
   }
   
@@ -153,14 +150,11 @@ class MultistageEnvelope {
     level_[1] = 32767;
     level_[2] = 0;
 
-    time_[0] = attack;
-    time_[1] = decay;
+    set_segment_time(0, attack, attack_multiplier_);
+    set_segment_time(1, decay, decay_multiplier_);
     
     shape_[0] = attack_shape_;
     shape_[1] = decay_shape_;
-
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
     
     loop_start_ = loop_start;
     loop_end_ = loop_end;
@@ -182,17 +176,13 @@ class MultistageEnvelope {
     level_[2] = sustain;
     level_[3] = 0;
 
-    time_[0] = attack;
-    time_[1] = decay;
-    time_[2] = release;
+    set_segment_time(0, attack, attack_multiplier_);
+    set_segment_time(1, decay, decay_multiplier_);
+    set_segment_time(2, release, release_multiplier_);
     
     shape_[0] = attack_shape_;
     shape_[1] = decay_shape_;
     shape_[2] = release_shape_;
-
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
-    time_multiplier_[2] = release_multiplier_;
     
     loop_start_ = loop_start ;
     loop_end_ = loop_end ;
@@ -207,14 +197,11 @@ class MultistageEnvelope {
     level_[1] = 32767;
     level_[2] = 0;
 
-    time_[0] = attack;
-    time_[1] = release;
+    set_segment_time(0, attack, attack_multiplier_);
+    set_segment_time(1, release, release_multiplier_);
     
     shape_[0] = attack_shape_;
     shape_[1] = release_shape_;
-
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = release_multiplier_;
     
     loop_start_ = loop_end_ = 0;
   }
@@ -234,20 +221,15 @@ class MultistageEnvelope {
     level_[3] = 32767;
     level_[4] = 0;
 
-    time_[0] = attack;
-    time_[1] = decay;
-    time_[2] = attack;
-    time_[3] = release;
+    set_segment_time(0, attack, attack_multiplier_);
+    set_segment_time(1, decay, decay_multiplier_);
+    set_segment_time(2, attack, attack_multiplier_);
+    set_segment_time(3, release, release_multiplier_);
     
     shape_[0] = attack_shape_;
     shape_[1] = decay_shape_;
     shape_[2] = attack_shape_;
     shape_[3] = release_shape_;
-
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
-    time_multiplier_[2] = attack_multiplier_;
-    time_multiplier_[3] = release_multiplier_;
     
     loop_start_ = loop_end_ = 0;
   }
@@ -269,20 +251,15 @@ class MultistageEnvelope {
     level_[3] = 32767;
     level_[4] = 0;
 
-    time_[0] = attack;
-    time_[1] = decay;
-    time_[2] = attack;
-    time_[3] = release;
+    set_segment_time(0, attack, attack_multiplier_);
+    set_segment_time(1, decay, decay_multiplier_);
+    set_segment_time(2, attack, attack_multiplier_);
+    set_segment_time(3, release, release_multiplier_);
     
     shape_[0] = attack_shape_;
     shape_[1] = decay_shape_;
     shape_[2] = attack_shape_;
     shape_[3] = release_shape_;
-
-    time_multiplier_[0] = attack_multiplier_;
-    time_multiplier_[1] = decay_multiplier_;
-    time_multiplier_[2] = attack_multiplier_;
-    time_multiplier_[3] = release_multiplier_;
    
     loop_start_ = loop_start;
     loop_end_ = loop_end;
@@ -370,9 +347,20 @@ class MultistageEnvelope {
   uint16_t RenderFastPreview(int16_t *values) const;
 
  private:
+  // The increment of a segment is only looked up when its time changes, so
+  // the times can be reconfigured every sample
+  inline void set_segment_time(uint16_t segment, uint16_t time, uint16_t time_multiplier) {
+    if (time != time_[segment] || time_multiplier != time_multiplier_[segment]) {
+      time_[segment] = time;
+      time_multiplier_[segment] = time_multiplier;
+      phase_increments_[segment] = lut_env_increments[time >> 8] >> time_multiplier;
+    }
+  }
+
   int16_t level_[kMaxNumSegments];
   uint16_t time_[kMaxNumSegments];
   uint16_t time_multiplier_[kMaxNumSegments];
+  uint32_t phase_increments_[kMaxNumSegments];
   EnvelopeShape shape_[kMaxNumSegments];
   
   int16_t segment_;
@@ -2,6 +2,8 @@
 #include "nostromo/applet/applet.h"
 #include "nostromo/clock.h"
 #include "nostromo/dsp.h"
+#include "nostromo/envelopes/adsr.h"
+#include "nostromo/fastmath.h"
 #include "nostromo/midi.h"
 #include "nostromo/math.h"
 #include "nostromo/fixed.h"
@@ -10,9 +12,12 @@
 #include "nostromo/oscillators/phasor.h"
 #include "nostromo/oscillators/shapes.h"
 #include "nostromo/oscillators/shark-tooth.h"
+#include "nostromo/oscillators/wavetable.h"
+#include "nostromo/packed.h"
 #include "nostromo/perlin.h"
 #include "nostromo/properties/property.h"
 #include "nostromo/properties/string_conversion.h"
+#include "nostromo/ramped_value.h"
 #include "nostromo/random.h"
 
 #define K(a) true
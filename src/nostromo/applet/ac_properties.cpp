@@ -56,3 +56,26 @@ String TimeStringConverter::propertyToString(const Property<float>& p)
   }
   return str;
 }
+
+ShortTimeStringConverter::ShortTimeStringConverter(Property<float>& p)
+: detail::StringConverterBase<float>(p)
+{}
+
+String ShortTimeStringConverter::propertyToString(const Property<float>& p)
+{
+  static char str[16];
+  if (p.value_ < 0.9995f)
+  {
+    snprintf(str, sizeof(str), "%dms", int(p.value_ * 1000.f + 0.5f));
+  }
+  else
+  if (p.value_ < 9.95f)
+  {
+    snprintf(str, sizeof(str), "%.1fs", p.value_);
+  }
+  else
+  {
+    snprintf(str, sizeof(str), "%ds", int(p.value_ + 0.5f));
+  }
+  return str;
+}
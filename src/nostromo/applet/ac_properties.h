@@ -69,3 +69,12 @@ public:
   TimeStringConverter(Property<float>& p);
   String propertyToString(const Property<float>& p) final;
 };
+
+// At most five characters ("220ms", "1.5s", "12s"), to fit labelled in a
+// column
+class ShortTimeStringConverter: public detail::StringConverterBase<float>
+{
+public:
+  ShortTimeStringConverter(Property<float>& p);
+  String propertyToString(const Property<float>& p) final;
+};
@@ -2,8 +2,10 @@
 
 #include "property_manager.h"
 #include "../ui/trigger_display.h"
+#include "../../../OC_config.h"
 
-constexpr static float kSampleRate = float(16667);
+// DSP rate of applets running at full control rate, i.e. once per core ISR
+constexpr static float kSampleRate = 1000000.f / float(OC_CORE_TIMER_RATE);
 
 template <class Model>
 class ArticCircleApplet: public HemisphereApplet
@@ -22,6 +24,44 @@ public:
     return (flank_[ch] == 1);
   }
 
+  // Heavy applets can run tick() only every `divider` ISRs (to be called from
+  // the constructor). Left and right hemispheres are scheduled on different
+  // ISRs, and gate flanks and clocks are latched in between so none are lost.
+  // Each applet picks its slot from its hemisphere, so the manager doesn't
+  // need to know which applets are divided.
+  void setControlRateDivider(int divider)
+  {
+    controlRateDivider_ = std::max(divider, 1);
+  }
+
+  // Rate at which tick() is called, to be used instead of kSampleRate
+  float controlRate() const
+  {
+    return kSampleRate / float(controlRateDivider_);
+  }
+
+  // Hides HemisphereApplet::Clock, which has side effects (cycle ticks, the
+  // clock manager's Tock) and must only run once per ISR. Controller() latches
+  // it and this reports the clocks received since the previous tick.
+  bool Clock(int ch, bool physical = 0)
+  {
+    return physical ? clocked_[ch].physical : clocked_[ch].logical;
+  }
+
+  // Same for CV changes, which the input conditioner only reports for the
+  // ISR that saw them
+  bool Changed(int ch)
+  {
+    return changed_[ch];
+  }
+
+  //! sample_t to DAC units without going through float: one is fullScale,
+  //! e.g. HEMISPHERE_MAX_CV for 5V
+  static int toCV(const sample_t& value, const int fullScale)
+  {
+    return ((value.value_ >> 12) * fullScale) >> (sample_t::shift_ - 12);
+  }
+
   void gfxPrintF(int x, int y, float value)
   {
     static char buffer[20];
@@ -96,30 +136,62 @@ public:
     {
       previousGate_[ch] = 0;
       flank_[ch] = 0;
+      pendingFlank_[ch] = 0;
+      pendingClock_[ch] = clocked_[ch] = {false, false};
+      pendingChanged_[ch] = changed_[ch] = false;
     }
+    // Round robin: the right hemisphere runs half a period after the left one
+    controlRateCounter_ = 0;
+    controlRateSlot_ = (hemisphere * controlRateDivider_) / 2;
   }
 
-/* Run during the interrupt service routine, 16667 times per second */
+/* Run during the interrupt service routine, kSampleRate times per second */
   void Controller()
   {
+    const bool divided = controlRateDivider_ > 1;
+
     ForEachChannel(ch)
     {
       bool gate = Gate(ch);
-      if (gate != previousGate_[ch])
+      const int flank = (gate != previousGate_[ch]) ? (gate ? 1 : -1) : 0;
+      // A rising flank takes precedence over a falling one seen since the last tick
+      if (flank != 0 && pendingFlank_[ch] != 1)
       {
-        flank_[ch] = gate ? 1 : -1;
+        pendingFlank_[ch] = flank;
       }
-      else
+      previousGate_[ch] = gate;
+      sizer_[ch].feed(gate);
+
+      // The physical clock is read straight from the input so the base class
+      // bookkeeping only runs for the logical one
+      pendingClock_[ch].logical |= HemisphereApplet::Clock(ch);
+      pendingClock_[ch].physical |= (OC::DigitalInputs::clocked(OC::DigitalInput(hemisphere * 2 + ch)) != 0);
+      pendingChanged_[ch] |= HemisphereApplet::Changed(ch);
+    }
+
+    if (divided)
+    {
+      const bool scheduled = (controlRateCounter_ == controlRateSlot_);
+      if (++controlRateCounter_ >= controlRateDivider_)
       {
-        flank_[ch] = 0;
+        controlRateCounter_ = 0;
+      }
+      if (!scheduled)
+      {
+        return;
       }
-      sizer_[ch].feed(gate);
     }
-    tick();
+
     ForEachChannel(ch)
     {
-      previousGate_[ch] = Gate(ch);
+      flank_[ch] = pendingFlank_[ch];
+      pendingFlank_[ch] = 0;
+      clocked_[ch] = pendingClock_[ch];
+      pendingClock_[ch] = {false, false};
+      changed_[ch] = pendingChanged_[ch];
+      pendingChanged_[ch] = false;
     }
+    tick();
   }
 
 /* Draw the screen */
@@ -224,4 +296,20 @@ protected:
   TriggerSizer<4> sizer_[2];
   bool previousGate_[2];
   int flank_[2];
+
+private:
+  struct Clocked
+  {
+    bool logical;
+    bool physical;
+  };
+
+  int controlRateDivider_ = 1;
+  int controlRateCounter_ = 0;
+  int controlRateSlot_ = 0;
+  int pendingFlank_[2];
+  Clocked pendingClock_[2];
+  Clocked clocked_[2];
+  bool pendingChanged_[2];
+  bool changed_[2];
  };
@@ -1,25 +1,134 @@
 #include "clock.h"
 
-void PingablePhaser::reset(float samplerate)
+#include <algorithm>
+
+void TempoTracker::reset()
+{
+  count_ = 0;
+  next_ = 0;
+  average_ = 0;
+  hasLastPing_ = false;
+  outliers_ = 0;
+}
+
+void TempoTracker::setAverageCount(std::size_t count)
+{
+  requestedAverageCount_ = (count < 1) ? 1 : (count > kMaxIntervals) ? kMaxIntervals : count;
+}
+
+void TempoTracker::applyAverageCount()
+{
+  const std::size_t count = requestedAverageCount_;
+  if (count == averageCount_)
+  {
+    return;
+  }
+  averageCount_ = count;
+  next_ = 0;
+  if (average_)
+  {
+    // Keep the current estimate by starting from a full window of it
+    for (std::size_t i = 0; i < count; i++)
+    {
+      intervals_[i] = average_;
+    }
+    count_ = count;
+  }
+  else
+  {
+    count_ = 0;
+  }
+}
+
+bool TempoTracker::ping(uint32_t pingTime)
+{
+  applyAverageCount();
+
+  if (!hasLastPing_)
+  {
+    hasLastPing_ = true;
+    lastPing_ = pingTime;
+    return false;
+  }
+
+  const uint32_t interval = pingTime - lastPing_;
+  lastPing_ = pingTime;
+
+  // Half or twice the current estimate is a missed or doubled clock, except
+  // when it's a lasting change of tempo
+  if (average_ && (interval < average_ / 2 || interval / 2 > average_))
+  {
+    if (++outliers_ < kOutlierRun)
+    {
+      return false;
+    }
+    count_ = 0;
+    next_ = 0;
+  }
+  outliers_ = 0;
+
+  intervals_[next_] = interval;
+  next_ = (next_ + 1) % averageCount_;
+  if (count_ < averageCount_)
+  {
+    ++count_;
+  }
+
+  uint64_t sum = 0;
+  for (std::size_t i = 0; i < count_; i++)
+  {
+    sum += intervals_[i];
+  }
+  average_ = uint32_t(sum / count_);
+  return true;
+}
+
+uint32_t TempoTracker::interval() const
+{
+  return average_;
+}
+
+void PingablePhaser::reset(float samplerate, float pingRate)
 {
   samplerate_ = samplerate;
-  lastPing_ = 0;
+  samplesPerPing_ = (pingRate > 0.f) ? samplerate / pingRate : 1.f;
   phase_ = 0;
   phaseIncrease_ = 0;
+  interval_ = 0;
+  intervalIncrease_ = 0;
+  tracker_.reset();
+}
+
+void PingablePhaser::setLoopGain(float gain)
+{
+  loopGain_ = sample_t(gain);
+}
+
+void PingablePhaser::setAverageCount(std::size_t count)
+{
+  tracker_.setAverageCount(count);
 }
 
 void PingablePhaser::ping(uint32_t pingTime)
 {
-  if (lastPing_ != 0)
+  if (!tracker_.ping(pingTime))
   {
-    // Get new tempo from interval
-    const auto delta = float(pingTime - lastPing_);
+    return;
+  }
+
+  // Only recompute the tempo when the tracked interval actually changed
+  const auto interval = tracker_.interval();
+  if (interval != interval_)
+  {
+    interval_ = interval;
+    const auto delta = float(interval) * samplesPerPing_;
     targetTempo_ = samplerate_ / delta * 60.f;
-    // Adapt phaser speed to we catch up phase wise
-    const auto offset = sample_t::frac(phase_ + sample_t(0.5)) - sample_t(0.5);
-    phaseIncrease_ = sample_t(1.f / delta) * (sample_t(1) - offset);
+    intervalIncrease_ = sample_t(1.f / delta);
   }
-  lastPing_ = pingTime;
+
+  // Adapt phaser speed so we catch up phase wise
+  const auto offset = sample_t::frac(phase_ + sample_t(0.5)) - sample_t(0.5);
+  phaseIncrease_ = intervalIncrease_ * (sample_t(1) - loopGain_ * offset);
 }
 
 sample_t PingablePhaser::tick()
@@ -35,11 +144,24 @@ float PingablePhaser::tempo() const
 
 void PhaserDivider::setAmount(int amount)
 {
-  amount_ = fixed(amount);
+  amount_ = std::max(amount, 1);
+  // Rounded down, so the output never reaches one
+  reciprocal_ = sample_t::fromRatio(1, amount_);
+  count_ %= amount_;
+}
+
+void PhaserDivider::reset()
+{
+  count_ = 0;
   lastValue_ = 0;
 }
 
 sample_t PhaserDivider::tick(sample_t value)
 {
-  return fixed::frac(fixed(value) * amount_);
+  if (value < lastValue_ && ++count_ >= amount_)
+  {
+    count_ = 0;
+  }
+  lastValue_ = value;
+  return (sample_t(count_) + value) * reciprocal_;
 }
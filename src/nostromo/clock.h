@@ -2,35 +2,85 @@
 
 #include "fixed.h"
 
+#include <cstddef>
 #include <functional>
 
+//! Estimates the interval between pings by averaging the last few of them.
+//! Intervals far off the current estimate (a missed or doubled clock) are
+//! ignored, unless they keep coming, in which case the tempo has changed.
+class TempoTracker
+{
+public:
+  static constexpr std::size_t kMaxIntervals = 8;
+  static constexpr int kOutlierRun = 3;
+
+  void reset();
+  //! Only latched here, applied on the next ping so it's safe to call from
+  //! the UI while the ISR is pinging
+  void setAverageCount(std::size_t count);
+
+  //! Returns false if the ping was rejected as an outlier
+  bool ping(uint32_t pingTime);
+
+  //! Average interval, 0 until at least one was measured
+  uint32_t interval() const;
+
+private:
+  uint32_t intervals_[kMaxIntervals];
+  std::size_t count_ = 0;
+  std::size_t next_ = 0;
+  std::size_t averageCount_ = 4;
+  volatile std::size_t requestedAverageCount_ = 4;
+  uint32_t average_ = 0;
+  uint32_t lastPing_ = 0;
+  bool hasLastPing_ = false;
+  int outliers_ = 0;
+
+  void applyAverageCount();
+};
+
+//! Phase locked to pings: the tempo follows the tracked interval, and the
+//! phase is pulled toward zero at each ping by the loop gain (1 locks within
+//! one period, smaller values follow jittery or swung clocks more smoothly).
 class PingablePhaser
 {
 public:
-  void reset(float samplerate);
+  //! pingRate is the rate of the time unit passed to ping(), it defaults to
+  //! the samplerate (i.e. ping times in ticks)
+  void reset(float samplerate, float pingRate = 0.f);
+  void setLoopGain(float gain);
+  void setAverageCount(std::size_t count);
   void ping(uint32_t pingTime);
   sample_t tick();
   float tempo() const;
 
 private:
   float samplerate_;
+  float samplesPerPing_;
   sample_t phase_ = 0;
   sample_t phaseIncrease_ = 0;
-  uint32_t lastPing_ = 0;
+  sample_t loopGain_ = 1;
+  uint32_t interval_ = 0;
+  sample_t intervalIncrease_ = 0;
   float targetTempo_ = 0;
+  TempoTracker tracker_;
 };
 
+//! Divides a phase: the output runs once for every `amount` cycles of the
+//! input, and stays coherent with it.
 class PhaserDivider
 {
 public:
-  using fixed = FixedFP<int32_t, 20>;
   void setAmount(int amount);
+  void reset();
 
   sample_t tick(sample_t value);
 
 private:
-  fixed lastValue_;
-  fixed amount_;
+  sample_t lastValue_;
+  sample_t reciprocal_ = 1;
+  int amount_ = 1;
+  int count_ = 0;
 };
 
 class FlankDetector
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "math.h"
+#include "fastmath.h"
 #include "fixed.h"
 #include <cmath>
 
@@ -17,20 +18,27 @@ T Sine(const T& x)
 {
   const auto FastSine = [](const T& value) -> T
   {
+    constexpr T c1 = T(3.138982);
+    constexpr T c3 = T(5.133625);
+    constexpr T c5 = T(2.428288);
+    constexpr T c7 = T(0.433645);
+
     const T xSquared = value * value;
 
     T currentPower = xSquared * value;
-    T result = T(3.138982) * value;
-    result -= T(5.133625) * currentPower;
+    T result = c1 * value;
+    result -= c3 * currentPower;
     currentPower *= xSquared;
-    result += T(2.428288) * currentPower;
+    result += c5 * currentPower;
     currentPower *= xSquared;
-    result -= T(0.433645) * currentPower;
+    result -= c7 * currentPower;
 
     return result;
   };
 
-  return FastSine((frac(x) - T(0.5)) * T(2));
+  constexpr T half = T(0.5);
+  constexpr T two = T(2);
+  return FastSine((frac(x) - half) * two);
 }
 
 template <typename T>
@@ -42,25 +50,37 @@ T Cosine(const T& x)
 template <typename T>
 T quadraticSine(const T& x)
 {
+  constexpr T kQuarter = T(0.25);
+  constexpr T kHalf = T(0.5);
+  constexpr T kThreeQuarters = T(0.75);
+  constexpr T kFour = T(4);
+  constexpr T kMinusFour = T(-4);
+  // Centers of the four quarter cycles
+  constexpr T kCenter0 = T(0.25 / 2.);
+  constexpr T kCenter1 = T(0.25 * 3. / 2.);
+  constexpr T kCenter2 = T(0.5 + 0.25 / 2.);
+  constexpr T kCenter3 = T(0.5 + 0.25 * 3. / 2.);
+
   const auto evaluatorFn = [](const T& a)
   {
-    return -a * a +T(0.75) + a;
+    constexpr T offset = T(0.75);
+    return -a * a + offset + a;
   };
 
-  if (x < T(0.5))
+  if (x < kHalf)
   {
     return evaluatorFn(
-      x < T(0.25)
-      ? (x - T(0.25 / 2.)) * T(4)
-      : (x - T(0.25 * 3. / 2.)) * T(-4)
+      x < kQuarter
+      ? (x - kCenter0) * kFour
+      : (x - kCenter1) * kMinusFour
     );
   }
   else
   {
     return -evaluatorFn(
-      x < T(0.75)
-      ? (x - T(0.5 + 0.25 / 2.)) * T(4)
-      : (x - T(0.5 + 0.25 * 3. / 2.)) * T(-4)
+      x < kThreeQuarters
+      ? (x - kCenter2) * kFour
+      : (x - kCenter3) * kMinusFour
     );
   }
 }
@@ -74,44 +94,64 @@ T quadraticCosine(const T& x)
 template <typename T>
 std::pair<T, T> quadraticSinCos(const T& x)
 {
+  constexpr T kQuarter = T(0.25);
+  constexpr T kHalf = T(0.5);
+  constexpr T kThreeQuarters = T(0.75);
+  constexpr T kFour = T(4);
+  constexpr T kMinusFour = T(-4);
+  constexpr T kCenter0 = T(0.25 / 2.);
+  constexpr T kCenter1 = T(0.25 * 3. / 2.);
+  constexpr T kCenter2 = T(0.5 + 0.25 / 2.);
+  constexpr T kCenter3 = T(0.5 + 0.25 * 3. / 2.);
+
   const auto evaluatorFn = [](const T& a)
   {
-    const auto c = T(sqrt(2.) / 2.);
-    return (T(2) - T(4) * c) *a *a + c;
+    // sqrt(2) / 2, and (2 - 4c) folded as well
+    constexpr T c = T(0.70710678118654752);
+    constexpr T a2 = T(2. - 4. * 0.70710678118654752);
+    return a2 * a * a + c;
   };
 
-  if (x < T(0.5))
+  if (x < kHalf)
   {
-    if (x < T(0.25))
+    if (x < kQuarter)
     {
-      const auto a = (x - T(0.25 / 2.)) * T(4);
+      const auto a = (x - kCenter0) * kFour;
       const auto t = evaluatorFn(a);
       return std::make_pair<T, T>(t + a, t - a);
     }
     else
     {
-      const auto a = (x - T(0.25 * 3. / 2.)) * T(-4);
+      const auto a = (x - kCenter1) * kMinusFour;
       const auto t = evaluatorFn(a);
       return std::make_pair<T, T>(t + a, a - t);
     }
   }
   else
   {
-    if (x < T(0.75))
+    if (x < kThreeQuarters)
     {
-      const auto a = (x - T(0.5 + 0.25 / 2.)) * T(4);
+      const auto a = (x - kCenter2) * kFour;
       const auto t = evaluatorFn(a);
       return std::make_pair<T, T>(-t - a, a - t);
     }
     else
     {
-      const auto a = (x - T(0.5 + 0.25 * 3. / 2.)) * T(-4);
+      const auto a = (x - kCenter3) * kMinusFour;
       const auto t = evaluatorFn(a);
       return std::make_pair<T, T>(- t - a, t - a);
     }
   }
 }
 
+// The constants above are compile time values of sample_t, within its range
+static_assert(float(sample_t(5.133625)) > 5.133f && float(sample_t(5.133625)) < 5.134f,
+  "FixedFP construction must fold at compile time");
+static_assert(sample_t(0.25 * 3. / 2.) + sample_t(0.25 / 2.) == sample_t(0.5),
+  "FixedFP arithmetic must fold at compile time");
+static_assert(float(sample_t(2. - 4. * 0.70710678118654752)) < -0.828f,
+  "FixedFP construction must fold at compile time");
+
 //------------------------------------------------------------------------------
 
 constexpr static float calcSlewCoeff(uint32_t sampleCount, float noiseFloor = 1e-4f)
@@ -129,6 +169,108 @@ static inline float onePoleCoeff(const float samplerate,
   }
   return 1.f;
 }
+
+//------------------------------------------------------------------------------
+// Table versions of the coefficients above
+//
+// Durations are given as log2 of a count of samples, in the units of pitch
+// CVs (12 << 7 per octave), so that a CV added to a time scales it by an
+// octave per volt. Coefficients are read from a table computed at compile
+// time: changing a time, even at audio rate, costs no exp or log.
+
+constexpr int kTimeUnitsPerOctave = 12 << 7;
+
+namespace time_tables
+{
+  //! e^(-1/n) for n from 2^-4 to 2^20, sixteen entries per octave
+  constexpr int kEntriesPerOctave = 16;
+  constexpr int kMinOctave = -4;
+  constexpr int kEntries = (20 - kMinOctave) * kEntriesPerOctave + 1;
+  constexpr int kUnitsPerEntry = kTimeUnitsPerOctave / kEntriesPerOctave;
+  constexpr int kMinUnits = kMinOctave * kTimeUnitsPerOctave;
+  constexpr int kMaxUnits = kMinUnits + (kEntries - 1) * kUnitsPerEntry;
+
+  //! 1536 * log2(ln(1e4)): calcSlewCoeff reaches its 1e-4 noise floor in
+  //! n samples, where e^(-1/n) takes ln(1e4) times as long
+  constexpr int kSlewOffset = 4920;
+
+  struct Table
+  {
+    int32_t decay[kEntries];
+  };
+
+  constexpr Table makeTable()
+  {
+    Table table{};
+    for (int i = 0; i < kEntries; i++)
+    {
+      const double octaves = double(kMinOctave) + double(i) / kEntriesPerOctave;
+      const double n = fastmath::detail::expSeries(octaves * fastmath::detail::kLn2);
+      const double value = fastmath::detail::expSeries(-1. / n) * double(1 << sample_t::shift_);
+      table.decay[i] = int32_t(value + 0.5);
+    }
+    return table;
+  }
+
+  constexpr Table kTable = makeTable();
+
+  //! e^(-1/n), n given in time units
+  inline sample_t decay(int units)
+  {
+    units = clamp(units, kMinUnits, kMaxUnits) - kMinUnits;
+    const int32_t index = units / kUnitsPerEntry;
+    if (index >= kEntries - 1)
+    {
+      return sample_t::fromValue(kTable.decay[kEntries - 1]);
+    }
+    const int32_t fraction = units % kUnitsPerEntry;
+    const int32_t a = kTable.decay[index];
+    const int32_t b = kTable.decay[index + 1];
+    return sample_t::fromValue(a + int32_t((int64_t(b - a) * fraction) / kUnitsPerEntry));
+  }
+}
+
+//! log2(samples) in time units, without libm
+inline int samplesToTimeUnits(uint32_t samples)
+{
+  if (samples <= 1)
+  {
+    return 0;
+  }
+  const int msb = 31 - __builtin_clz(samples);
+  const uint32_t position = (msb > 0) ? samples << (32 - msb) : 0;
+  const int32_t fraction = fastmath::detail::read(fastmath::detail::kLog2, position);
+  return msb * kTimeUnitsPerOctave
+    + int((int64_t(fraction) * kTimeUnitsPerOctave) >> sample_t::shift_);
+}
+
+inline int secondsToTimeUnits(const float seconds, const float samplerate)
+{
+  return samplesToTimeUnits(uint32_t(seconds * samplerate));
+}
+
+//! As calcSlewCoeff(samples), i.e. reaching 1e-4 after that many samples
+inline sample_t slewCoeff(const int timeUnits)
+{
+  return time_tables::decay(timeUnits - time_tables::kSlewOffset);
+}
+
+//! As onePoleCoeff, the time being the time constant
+inline sample_t onePoleCoeff(const int timeUnits)
+{
+  return sample_t(1) - time_tables::decay(timeUnits);
+}
+
+//! 1 / samples, the step of a linear ramp lasting that long
+inline sample_t linearCoeff(const int timeUnits)
+{
+  const int units = (timeUnits > 0) ? timeUnits : 0;
+  const int octave = units / kTimeUnitsPerOctave;
+  const int rest = units - octave * kTimeUnitsPerOctave;
+  // 2^-rest in (0.5, 1]
+  const auto x = sample_t::fromValue(-rest * ((1 << sample_t::shift_) / kTimeUnitsPerOctave));
+  return sample_t::fromValue((octave < 31) ? fastmath::exp2(x).value_ >> octave : 0);
+}
 //------------------------------------------------------------------------------
 
 template <typename T>
@@ -187,7 +329,13 @@ public:
 
   void setSlopes(const uint32_t attack, const uint32_t decay)
   {
-    setCoeffs(calcSlewCoeff(attack), calcSlewCoeff(decay));
+    setTimes(samplesToTimeUnits(attack), samplesToTimeUnits(decay));
+  }
+
+  //! Times in time units, see slewCoeff
+  void setTimes(const int attack, const int decay)
+  {
+    setCoeffs(T(slewCoeff(attack)), T(slewCoeff(decay)));
   }
 
   void setCoeffs(const T& a, const T& d)
@@ -248,6 +396,13 @@ public:
     releaseCoef_ = T(1.f/float(releaseInSamples));
   }
 
+  //! Times in time units, see linearCoeff
+  void setTimes(const int attack, const int release)
+  {
+    attackCoef_ = T(linearCoeff(attack));
+    releaseCoef_ = T(linearCoeff(release));
+  }
+
   T tick(bool gate)
   {
     if (target_ == T(1))
@@ -296,3 +451,300 @@ private:
   T attackCoef_;
   T releaseCoef_;
 };
+
+//------------------------------------------------------------------------------
+// Filters
+//
+// Topology preserving (trapezoidal) one-pole and state variable filters, and
+// a DC blocker. Cutoffs are given in Hemisphere pitch units (128 per
+// semitone) and turned into coefficients by reading a table computed at
+// compile time, so they can follow a CV at audio rate.
+
+namespace filter_tables
+{
+  //! Twelve octaves of semitones, ending at kMaxRatio * samplerate
+  constexpr int kUnitsPerSemitone = 128;
+  constexpr int kEntries = 12 * 12 + 1;
+  constexpr int kMaxUnits = (kEntries - 1) * kUnitsPerSemitone;
+  //! Just below Nyquist, where g = tan(pi * fc / fs) stays within sample_t
+  constexpr double kMaxRatio = 0.45;
+
+  struct Table
+  {
+    int32_t g[kEntries];
+    int32_t onePole[kEntries];
+  };
+
+  constexpr double tanSeries(double x)
+  {
+    return fastmath::detail::sinSeries(x) / fastmath::detail::sinSeries(fastmath::detail::kPi / 2. - x);
+  }
+
+  constexpr int32_t toSample(double value)
+  {
+    return int32_t(value * double(1 << sample_t::shift_) + 0.5);
+  }
+
+  constexpr Table makeTable()
+  {
+    Table table{};
+    for (int i = 0; i < kEntries; i++)
+    {
+      const double octaves = double(i - (kEntries - 1)) / 12.;
+      const double ratio = kMaxRatio * fastmath::detail::expSeries(octaves * fastmath::detail::kLn2);
+      const double g = tanSeries(fastmath::detail::kPi * ratio);
+      table.g[i] = toSample(g);
+      table.onePole[i] = toSample(g / (1. + g));
+    }
+    return table;
+  }
+
+  constexpr Table kTable = makeTable();
+
+  static_assert(kTable.g[kEntries - 1] < (8 << sample_t::shift_) && kTable.g[0] > 0,
+    "Cutoff table must stay within sample_t");
+
+  //! units in [0, kMaxUnits]
+  inline sample_t read(const int32_t* table, int32_t units)
+  {
+    const int32_t index = units / kUnitsPerSemitone;
+    if (index >= kEntries - 1)
+    {
+      return sample_t::fromValue(table[kEntries - 1]);
+    }
+    const int32_t fraction = units % kUnitsPerSemitone;
+    const int32_t a = table[index];
+    const int32_t b = table[index + 1];
+    return sample_t::fromValue(a + int32_t((int64_t(b - a) * fraction) / kUnitsPerSemitone));
+  }
+}
+
+//! Cutoff of a filter in Hemisphere pitch units, 0 being baseFrequency.
+//! Cutoffs beyond the table are clamped, the lowest is kMaxRatio / 4096 of
+//! the sample rate (about 1.8 Hz at the core rate).
+class FilterCutoff
+{
+public:
+  static constexpr int kUnitsPerOctave = 12 << 7;
+
+  void reset(const float samplerate, const float baseFrequency)
+  {
+    const float octaves = std::log2(baseFrequency / (samplerate * float(filter_tables::kMaxRatio)));
+    offset_ = filter_tables::kMaxUnits + int(octaves * kUnitsPerOctave + 0.5f);
+    pitch_ = 0;
+    update();
+  }
+
+  //! Returns false when the cutoff is unchanged
+  bool setPitch(const int pitch)
+  {
+    if (pitch == pitch_)
+    {
+      return false;
+    }
+    pitch_ = pitch;
+    update();
+    return true;
+  }
+
+  //! tan(pi * fc / fs)
+  sample_t g() const
+  {
+    return g_;
+  }
+
+  //! g / (1 + g), the gain of a one-pole
+  sample_t onePole() const
+  {
+    return onePole_;
+  }
+
+private:
+  void update()
+  {
+    const int32_t units = clamp(pitch_ + offset_, 0, filter_tables::kMaxUnits);
+    g_ = filter_tables::read(filter_tables::kTable.g, units);
+    onePole_ = filter_tables::read(filter_tables::kTable.onePole, units);
+  }
+
+  int pitch_ = 0;
+  int offset_ = 0;
+  sample_t g_;
+  sample_t onePole_;
+};
+
+//! One-pole lowpass and its complementary highpass, e.g. to smooth a CV
+class OnePoleFilter
+{
+public:
+  //! Cutoffs are relative to baseFrequency
+  void reset(const float samplerate, const float baseFrequency)
+  {
+    cutoff_.reset(samplerate, baseFrequency);
+    state_ = lowpass_ = highpass_ = sample_t(0);
+  }
+
+  void setCutoff(const int pitch)
+  {
+    cutoff_.setPitch(pitch);
+  }
+
+  //! Returns the lowpass
+  sample_t tick(const sample_t& in)
+  {
+    const auto v = (in - state_) * cutoff_.onePole();
+    lowpass_ = v + state_;
+    state_ = lowpass_ + v;
+    highpass_ = in - lowpass_;
+    return lowpass_;
+  }
+
+  sample_t lowpass() const
+  {
+    return lowpass_;
+  }
+
+  sample_t highpass() const
+  {
+    return highpass_;
+  }
+
+private:
+  FilterCutoff cutoff_;
+  sample_t state_;
+  sample_t lowpass_;
+  sample_t highpass_;
+};
+
+//! Two-pole state variable filter with lowpass, bandpass and highpass
+//! outputs. Stable at any cutoff in the table; with inputs in [-1, 1] the
+//! outputs stay within sample_t up to the maximum resonance.
+class StateVariableFilter
+{
+public:
+  //! Damping at full resonance, i.e. a Q of 5
+  static constexpr float kMinDamping = 0.2f;
+
+  //! Cutoffs are relative to baseFrequency
+  void reset(const float samplerate, const float baseFrequency)
+  {
+    cutoff_.reset(samplerate, baseFrequency);
+    state1_ = state2_ = sample_t(0);
+    lowpass_ = bandpass_ = highpass_ = sample_t(0);
+    updateCoefficients();
+  }
+
+  void setCutoff(const int pitch)
+  {
+    if (cutoff_.setPitch(pitch))
+    {
+      updateCoefficients();
+    }
+  }
+
+  //! resonance in [0, 1]
+  void setResonance(const sample_t& resonance)
+  {
+    const auto damping = sample_t(2) - clamp(resonance, sample_t(0), sample_t(1)) * sample_t(2.f - kMinDamping);
+    if (damping != damping_)
+    {
+      damping_ = damping;
+      updateCoefficients();
+    }
+  }
+
+  //! Returns the lowpass
+  sample_t tick(const sample_t& in)
+  {
+    const auto v3 = in - state2_;
+    const auto v1 = a1_ * state1_ + a2_ * v3;
+    const auto v2 = state2_ + a2_ * state1_ + a3_ * v3;
+    state1_ = v1 + v1 - state1_;
+    state2_ = v2 + v2 - state2_;
+
+    lowpass_ = v2;
+    bandpass_ = v1;
+    highpass_ = in - damping_ * v1 - v2;
+    return lowpass_;
+  }
+
+  sample_t lowpass() const
+  {
+    return lowpass_;
+  }
+
+  sample_t bandpass() const
+  {
+    return bandpass_;
+  }
+
+  sample_t highpass() const
+  {
+    return highpass_;
+  }
+
+private:
+  // Only when the cutoff or the resonance moves. 1 + g (g + damping) goes
+  // well beyond sample_t near Nyquist, so it's kept in 64 bits and inverted
+  // by a table read rather than a division.
+  void updateCoefficients()
+  {
+    const int64_t g = cutoff_.g().value_;
+    const int64_t gain = (g * (g + damping_.value_)) >> sample_t::shift_;
+    a1_ = fastmath::inverse(uint64_t(sample_t(1).value_ + gain));
+    a2_ = cutoff_.g() * a1_;
+    a3_ = cutoff_.g() * a2_;
+  }
+
+  FilterCutoff cutoff_;
+  sample_t damping_ = sample_t(2);
+  sample_t a1_;
+  sample_t a2_;
+  sample_t a3_;
+  sample_t state1_;
+  sample_t state2_;
+  sample_t lowpass_;
+  sample_t bandpass_;
+  sample_t highpass_;
+};
+
+//! Removes the DC offset of a signal: y[n] = x[n] - x[n-1] + r y[n-1], with
+//! the pole r matching a one-pole highpass at the given cutoff
+class DCBlocker
+{
+public:
+  void reset(const float samplerate, const float cutoffFrequency = 10.f)
+  {
+    cutoff_.reset(samplerate, cutoffFrequency);
+    lastIn_ = lastOut_ = sample_t(0);
+    updatePole();
+  }
+
+  //! Moves the cutoff away from cutoffFrequency, in pitch units
+  void setCutoff(const int pitch)
+  {
+    if (cutoff_.setPitch(pitch))
+    {
+      updatePole();
+    }
+  }
+
+  sample_t tick(const sample_t& in)
+  {
+    lastOut_ = in - lastIn_ + pole_ * lastOut_;
+    lastIn_ = in;
+    return lastOut_;
+  }
+
+private:
+  // (1 - g) / (1 + g), as the bilinear transform places it
+  void updatePole()
+  {
+    pole_ = sample_t(1) - cutoff_.onePole() * sample_t(2);
+  }
+
+  FilterCutoff cutoff_;
+  sample_t pole_;
+  sample_t lastIn_;
+  sample_t lastOut_;
+};
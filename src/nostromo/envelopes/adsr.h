@@ -0,0 +1,216 @@
+#pragma once
+
+#include "../dsp.h"
+#include "../fixed.h"
+
+#include "../../../extern/stmlib_utils_dsp.h"
+#include "../../../peaks_multistage_envelope.h"
+#include "../../../peaks_resources.h"
+
+#include <cstdint>
+
+//! Attack, decay, sustain, release envelope with the curves of the peaks
+//! envelopes. A timed stage runs a 32 bit phase up to 2^32 at an increment
+//! cached per stage, so a tick costs an add and a read of the stage curve;
+//! increments are only recomputed when a time or its modulation moves.
+//!
+//! Times are in time units (see slewCoeff), so a modulation in the same
+//! units, e.g. a CV, scales a stage by an octave per volt.
+class ADSREnvelope
+{
+public:
+  enum class Stage
+  {
+    Attack,
+    Decay,
+    Release,
+    Sustain,
+    Idle
+  };
+
+  //! What a rising gate does while the envelope is still releasing:
+  //! Retrigger starts a new attack from the current level, Legato goes
+  //! straight back to the sustain level without a new attack
+  enum class Triggering
+  {
+    Retrigger,
+    Legato
+  };
+
+  //! About a minute at the core rate, longer stages would stall
+  static constexpr int kMaxTime = 20 * kTimeUnitsPerOctave;
+
+  void init()
+  {
+    stage_ = Stage::Idle;
+    triggering_ = Triggering::Retrigger;
+    gate_ = false;
+    phase_ = 0;
+    start_ = value_ = sample_t(0);
+    sustain_ = sample_t(0.5);
+    for (int s = 0; s < kTimedStages; s++)
+    {
+      times_[s] = 0;
+      modulations_[s] = 0;
+      updateIncrement(s);
+    }
+    // As peaks does
+    shapes_[int(Stage::Attack)] = peaks::ENV_SHAPE_QUARTIC;
+    shapes_[int(Stage::Decay)] = peaks::ENV_SHAPE_EXPONENTIAL;
+    shapes_[int(Stage::Release)] = peaks::ENV_SHAPE_EXPONENTIAL;
+  }
+
+  //! Attack, Decay or Release only
+  void setTime(const Stage stage, const int timeUnits)
+  {
+    const int s = int(stage);
+    if (times_[s] != timeUnits)
+    {
+      times_[s] = timeUnits;
+      updateIncrement(s);
+    }
+  }
+
+  //! Added to the time of a stage, in time units
+  void setModulation(const Stage stage, const int timeUnits)
+  {
+    const int s = int(stage);
+    if (modulations_[s] != timeUnits)
+    {
+      modulations_[s] = timeUnits;
+      updateIncrement(s);
+    }
+  }
+
+  void setShape(const Stage stage, const peaks::EnvelopeShape shape)
+  {
+    shapes_[int(stage)] = shape;
+  }
+
+  //! In [0, 1], followed live by the decay and sustain stages
+  void setSustain(const sample_t& level)
+  {
+    sustain_ = clamp(level, sample_t(0), sample_t(1));
+  }
+
+  void setTriggering(const Triggering triggering)
+  {
+    triggering_ = triggering;
+  }
+
+  //! Returns the level, in [0, 1]
+  sample_t tick(const bool gate)
+  {
+    if (gate && !gate_)
+    {
+      const bool legato = (triggering_ == Triggering::Legato) && (stage_ == Stage::Release);
+      enter(legato ? Stage::Decay : Stage::Attack);
+    }
+    else if (!gate && gate_ && stage_ != Stage::Idle)
+    {
+      enter(Stage::Release);
+    }
+    gate_ = gate;
+
+    switch (stage_)
+    {
+      case Stage::Sustain:
+        value_ = sustain_;
+        return value_;
+
+      case Stage::Idle:
+        return value_;
+
+      default:
+        break;
+    }
+
+    const int s = int(stage_);
+    const uint32_t increment = increments_[s];
+    if (phase_ > UINT32_MAX - increment)
+    {
+      endStage();
+      return value_;
+    }
+    phase_ += increment;
+
+    const uint16_t curve = stmlib::Interpolate824(peaks::lookup_table_table[LUT_ENV_LINEAR + shapes_[s]], phase_);
+    value_ = start_ + (target() - start_) * sample_t::fromValue(int32_t(curve) << (sample_t::shift_ - 16));
+    return value_;
+  }
+
+  Stage stage() const
+  {
+    return stage_;
+  }
+
+  sample_t value() const
+  {
+    return value_;
+  }
+
+private:
+  static constexpr int kTimedStages = 3;
+
+  void enter(const Stage stage)
+  {
+    stage_ = stage;
+    start_ = value_;
+    phase_ = 0;
+  }
+
+  void endStage()
+  {
+    switch (stage_)
+    {
+      case Stage::Attack:
+        value_ = sample_t(1);
+        enter(Stage::Decay);
+        break;
+
+      case Stage::Decay:
+        value_ = sustain_;
+        enter(Stage::Sustain);
+        break;
+
+      default:
+        value_ = sample_t(0);
+        enter(Stage::Idle);
+        break;
+    }
+  }
+
+  sample_t target() const
+  {
+    switch (stage_)
+    {
+      case Stage::Attack:
+        return sample_t(1);
+      case Stage::Decay:
+        return sustain_;
+      default:
+        return sample_t(0);
+    }
+  }
+
+  // A whole phase in 1 / samples of the stage: 2^32 * linearCoeff
+  void updateIncrement(const int s)
+  {
+    const int time = times_[s] + modulations_[s];
+    const int units = (time > kMaxTime) ? kMaxTime : time;
+    const uint64_t increment = uint64_t(linearCoeff(units).value_) << (32 - sample_t::shift_);
+    increments_[s] = (increment > UINT32_MAX) ? UINT32_MAX : uint32_t(increment);
+  }
+
+  Stage stage_;
+  Triggering triggering_;
+  bool gate_;
+  uint32_t phase_;
+  sample_t start_;
+  sample_t value_;
+  sample_t sustain_;
+  int times_[kTimedStages];
+  int modulations_[kTimedStages];
+  uint32_t increments_[kTimedStages];
+  peaks::EnvelopeShape shapes_[kTimedStages];
+};
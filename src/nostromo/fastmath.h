@@ -0,0 +1,213 @@
+#pragma once
+
+#include "fixed.h"
+
+#include <cstdint>
+
+// Constant time math on sample_t: each function is a read of a table with
+// linear interpolation. The tables are computed by the compiler (constexpr
+// series below) and end up in flash.
+//
+// Maximum errors against libm, measured on the host over the whole domain:
+//   sin    kSinMaxError        absolute
+//   exp2   kExp2MaxError       relative, for x >= -8 (about 0.005 cent as a pitch)
+//   log2   kLog2MaxError       absolute
+//   tanh   kTanhMaxError       absolute
+//   inverse kInverseMaxError   absolute
+
+namespace fastmath
+{
+  constexpr float kSinMaxError = 8e-5f;
+  constexpr float kExp2MaxError = 3e-6f;
+  constexpr float kLog2MaxError = 3e-6f;
+  constexpr float kTanhMaxError = 1e-4f;
+  constexpr float kInverseMaxError = 5e-6f;
+
+  namespace detail
+  {
+    constexpr int kTableBits = 8;
+    constexpr int kTableSize = 1 << kTableBits;
+
+    struct Table
+    {
+      int32_t values[kTableSize + 1];
+    };
+
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kLn2 = 0.69314718055994530942;
+
+    // Series, only evaluated at compile time
+
+    //! x in [-pi, pi]
+    constexpr double sinSeries(double x)
+    {
+      double term = x;
+      double sum = x;
+      for (int n = 1; n < 20; n++)
+      {
+        term *= -x * x / double((2 * n) * (2 * n + 1));
+        sum += term;
+      }
+      return sum;
+    }
+
+    constexpr double expSeries(double x)
+    {
+      int squarings = 0;
+      while (x > 0.5 || x < -0.5)
+      {
+        x /= 2.;
+        squarings++;
+      }
+      double term = 1.;
+      double sum = 1.;
+      for (int n = 1; n < 20; n++)
+      {
+        term *= x / double(n);
+        sum += term;
+      }
+      for (; squarings > 0; squarings--)
+      {
+        sum *= sum;
+      }
+      return sum;
+    }
+
+    //! x in [1, 2], through ln(x) = 2 atanh((x - 1) / (x + 1))
+    constexpr double logSeries(double x)
+    {
+      const double z = (x - 1.) / (x + 1.);
+      double power = z;
+      double sum = 0.;
+      for (int n = 0; n < 30; n++)
+      {
+        sum += power / double(2 * n + 1);
+        power *= z * z;
+      }
+      return 2. * sum;
+    }
+
+    // Table contents, over [0, 1]
+
+    constexpr double sinCycle(double x)
+    {
+      return sinSeries(2. * kPi * ((x > 0.5) ? x - 1. : x));
+    }
+
+    constexpr double exp2Octave(double x)
+    {
+      return expSeries(x * kLn2);
+    }
+
+    constexpr double log2Octave(double x)
+    {
+      return logSeries(1. + x) / kLn2;
+    }
+
+    //! Covers tanh over [0, 8]
+    constexpr double tanhRange(double x)
+    {
+      const double e = expSeries(16. * x);
+      return (e - 1.) / (e + 1.);
+    }
+
+    constexpr double inverseOctave(double x)
+    {
+      return 1. / (1. + x);
+    }
+
+    constexpr Table makeTable(double (*fn)(double))
+    {
+      Table table{};
+      for (int i = 0; i <= kTableSize; i++)
+      {
+        const double value = fn(double(i) / kTableSize) * double(1 << sample_t::shift_);
+        table.values[i] = int32_t(value + ((value >= 0.) ? 0.5 : -0.5));
+      }
+      return table;
+    }
+
+    constexpr Table kSin = makeTable(sinCycle);
+    constexpr Table kExp2 = makeTable(exp2Octave);
+    constexpr Table kLog2 = makeTable(log2Octave);
+    constexpr Table kTanh = makeTable(tanhRange);
+    constexpr Table kInverse = makeTable(inverseOctave);
+
+    static_assert(kExp2.values[kTableSize] == 2 << sample_t::shift_, "exp2 table must span an octave");
+
+    //! position is [0, 1) in 32 bits
+    inline int32_t read(const Table& table, uint32_t position)
+    {
+      const uint32_t index = position >> (32 - kTableBits);
+      const int32_t fraction = (position >> (32 - kTableBits - 15)) & 0x7fff;
+      const int32_t a = table.values[index];
+      const int32_t b = table.values[index + 1];
+      return a + int32_t((int64_t(b - a) * fraction) >> 15);
+    }
+  }
+
+  //! sin(2 pi x), x in cycles
+  inline sample_t sin(const sample_t& x)
+  {
+    const uint32_t position = uint32_t(x.value_) << (32 - sample_t::shift_);
+    return sample_t::fromValue(detail::read(detail::kSin, position));
+  }
+
+  //! 2^x, saturated for x >= 4
+  inline sample_t exp2(const sample_t& x)
+  {
+    const int32_t octave = x.value_ >> sample_t::shift_;
+    const uint32_t position = uint32_t(x.value_) << (32 - sample_t::shift_);
+    const int32_t mantissa = detail::read(detail::kExp2, position);
+    if (octave >= 0)
+    {
+      // The mantissa is in [1, 2), sample_t below 16
+      return (octave >= 4) ? sample_t::SMax() : sample_t::fromValue(mantissa << octave);
+    }
+    return sample_t::fromValue((octave > -32) ? mantissa >> -octave : 0);
+  }
+
+  //! log2(x), SMin (-16) below 2^-16, where it would not fit sample_t
+  inline sample_t log2(const sample_t& x)
+  {
+    constexpr int kMinMsb = sample_t::shift_ - 16;
+    const int msb = (x.value_ > 0) ? 31 - __builtin_clz(uint32_t(x.value_)) : -1;
+    if (msb < kMinMsb)
+    {
+      return sample_t::SMin();
+    }
+    // Mantissa bits below the leading one
+    const uint32_t position = uint32_t(x.value_) << (32 - msb);
+    const int32_t mantissa = detail::read(detail::kLog2, position);
+    return sample_t::fromValue((msb - sample_t::shift_) * (1 << sample_t::shift_) + mantissa);
+  }
+
+  //! tanh(x), saturated to +/-1 outside of [-8, 8]
+  inline sample_t tanh(const sample_t& x)
+  {
+    const bool negative = x.value_ < 0;
+    const uint32_t magnitude = negative ? -uint32_t(x.value_) : uint32_t(x.value_);
+    // [0, 8) mapped on 32 bits
+    const uint32_t limit = uint32_t(8) << sample_t::shift_;
+    const int32_t value = (magnitude >= limit)
+      ? (1 << sample_t::shift_)
+      : detail::read(detail::kTanh, magnitude << (32 - sample_t::shift_ - 3));
+    return sample_t::fromValue(negative ? -value : value);
+  }
+
+  //! 1 / x for x >= 1, where x is the raw Q27 value of a sample_t in 64 bits:
+  //! the result fits sample_t even when x doesn't, e.g. a filter's 1 + g^2
+  inline sample_t inverse(const uint64_t value)
+  {
+    const int msb = 63 - __builtin_clzll(value | 1);
+    const int octave = msb - sample_t::shift_;
+    if (octave < 0)
+    {
+      return sample_t(1);
+    }
+    // Mantissa bits below the leading one
+    const uint32_t position = uint32_t((value << (63 - msb)) >> 31);
+    const int32_t mantissa = detail::read(detail::kInverse, position);
+    return sample_t::fromValue(mantissa >> octave);
+  }
+}
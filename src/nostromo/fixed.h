@@ -6,6 +6,11 @@
 #include <ostream>
 #include <algorithm>
 #include <stdint.h>
+#include <limits>
+
+#if defined(KINETISK)
+#include "../../extern/dspinst.h"
+#endif
 
 //------------------------------
 
@@ -14,43 +19,124 @@
 
 //------------------------------
 
-// C is the storage container (int32_t for a 32bit for example)
+// Overflow policies of the FixedFP arithmetic. add() and sub() get the two
+// operands, narrow() brings back the wider result of a multiply, divide or
+// negation to the container.
 
-template <typename C,uint8_t F>
+//! Wraps around like plain integers, at no cost (the default)
+struct Wrapping
+{
+  template <typename C, uint8_t F>
+  static constexpr C add(const C& a, const C& b)
+  {
+    return static_cast<C>(a + b);
+  }
+
+  template <typename C, uint8_t F>
+  static constexpr C sub(const C& a, const C& b)
+  {
+    return static_cast<C>(a - b);
+  }
+
+  template <typename C, uint8_t F, typename P>
+  static constexpr C narrow(const P& wide)
+  {
+    return static_cast<C>(wide);
+  }
+};
+
+//! Clamps to the range of the container, with QADD, QSUB and SSAT on the
+//! Cortex-M4, and a check of the high word for 64 bit products
+struct Saturating
+{
+  template <typename C, uint8_t F>
+  static C add(const C& a, const C& b)
+  {
+#if defined(KINETISK)
+    if (sizeof(C) == sizeof(int32_t))
+    {
+      return add_32_saturate(a, b);
+    }
+#endif
+    return narrow<C, F>(int64_t(a) + b);
+  }
+
+  template <typename C, uint8_t F>
+  static C sub(const C& a, const C& b)
+  {
+#if defined(KINETISK)
+    if (sizeof(C) == sizeof(int32_t))
+    {
+      return substract_32_saturate(a, b);
+    }
+#endif
+    return narrow<C, F>(int64_t(a) - b);
+  }
+
+  template <typename C, uint8_t F, typename P>
+  static C narrow(const P& wide)
+  {
+#if defined(KINETISK)
+    if (sizeof(P) <= sizeof(int32_t))
+    {
+      return signed_saturate_rshift(wide, 8 * sizeof(C), 0);
+    }
+    if (sizeof(C) == sizeof(int32_t))
+    {
+      // A 64 bit result fits when its top 33 bits are all equal, otherwise
+      // the sign of the high word picks the bound: no 64 bit compares
+      const int32_t high = int32_t(int64_t(wide) >> 32);
+      const int32_t low = int32_t(wide);
+      return (high == (low >> 31)) ? C(low) : C((high >> 31) ^ INT32_MAX);
+    }
+#endif
+    return static_cast<C>(std::max<P>(std::min<P>(wide, std::numeric_limits<C>::max()),
+      std::numeric_limits<C>::min()));
+  }
+};
+
+//------------------------------
+
+// C is the storage container (int32_t for a 32bit for example), O the
+// overflow policy
+
+template <typename C,uint8_t F,typename O = Wrapping>
 class FixedFP {
 
-  template<typename C2, uint8_t F2> friend class FixedFP;
+  template<typename C2, uint8_t F2, typename O2> friend class FixedFP;
 
 public:
 
   // Constructors
 
-  inline FixedFP() {
-    value_ = 0;
-  }
+  constexpr FixedFP()
+  : value_(0)
+  {}
 
-  inline FixedFP(const float& f) {
-    value_ = static_cast<C>(f * (1 << shift_));
-  }
+  constexpr FixedFP(const float& f)
+  : value_(static_cast<C>(f * (1 << shift_)))
+  {}
 
-  inline FixedFP(const double& d) {
-    value_ = static_cast<C>(d * (1 << shift_));
-  }
+  constexpr FixedFP(const double& d)
+  : value_(static_cast<C>(d * (1 << shift_)))
+  {}
 
-  inline FixedFP(const int& i) {
-    value_ = i << shift_;
-  }
+  // A multiply rather than a shift, which is undefined for negative values
+  // and so not allowed in constant expressions
+  constexpr FixedFP(const int& i)
+  : value_(static_cast<C>(i * (C(1) << shift_)))
+  {}
 
   // Factory
 
-  static inline FixedFP fromValue(const C& value)
+  static constexpr FixedFP fromValue(const C& value)
   {
     FixedFP fp;
     fp.value_ = value;
     return fp;
   }
 
-  static inline FixedFP fromRatio(const C& numerator, const C& denominator)
+  static constexpr FixedFP fromRatio(const C& numerator, const C& denominator)
   {
     FixedFP n,d;
     n.value_ = numerator;
@@ -58,24 +144,38 @@ public:
     return n/d;
   }
 
+  //! numerator / 2^bits, with a shift instead of a division
+  static constexpr FixedFP fromRatioPow2(const C& numerator, const uint8_t bits)
+  {
+    FixedFP fp;
+    fp.value_ = (bits <= F) ? numerator << (F - bits) : numerator >> (bits - F);
+    return fp;
+  }
+
   // Min - Max
 
-  static FixedFP SMax()
+  static constexpr FixedFP SMax()
   {
     FixedFP max;
     max.value_ = FP_MAX_VAL;
     return max;
   }
 
-  static FixedFP SMin()
+  static constexpr FixedFP SMin()
   {
     FixedFP max;
     max.value_ = FP_MIN_VAL;
     return max;
   }
 
+  //! Changes the overflow policy, e.g. to saturate one stage of an algorithm
+  template <typename O2>
+  explicit constexpr FixedFP(FixedFP<C, F, O2> const &rhs)
+    :value_(rhs.value_)
+  {}
+
   template <unsigned char F2>
-  inline FixedFP(FixedFP<C, F2> const &rhs)
+  constexpr FixedFP(FixedFP<C, F2, O> const &rhs)
     :value_(rhs.value_)
   {
     int diff = F - F2;
@@ -87,13 +187,11 @@ public:
     }
   }
 
-  inline FixedFP &operator=(const FixedFP &rhs) {
-    value_ = rhs.value_;
-    return *this;
-  }
+  constexpr FixedFP(const FixedFP &rhs) = default;
+  constexpr FixedFP &operator=(const FixedFP &rhs) = default;
 
   template <unsigned char F2>
-  inline FixedFP<C, F> &operator=(const FixedFP<C, F2> &rhs) {
+  constexpr FixedFP &operator=(const FixedFP<C, F2, O> &rhs) {
     if (rhs.shift_ < shift_) {
       value_ = (rhs.value_) << (shift_ - rhs.shift_);
     }
@@ -103,24 +201,24 @@ public:
     return *this;
   }
 
-  inline operator int() const {
+  constexpr operator int() const {
     return value_ >> shift_;
   }
 
-  inline operator float() const {
+  constexpr operator float() const {
     return float(value_) / (1 << shift_);
   };
 
-  inline operator double() const {
+  constexpr operator double() const {
     return double(value_) / (1 << shift_);
   };
 
-  inline FixedFP &operator+=(const FixedFP &rhs) {
-    value_ += rhs.value_;
+  constexpr FixedFP &operator+=(const FixedFP &rhs) {
+    value_ = O::template add<C, F>(value_, rhs.value_);
     return *this;
   }
 
-  inline FixedFP &ads(const FixedFP &rhs)
+  constexpr FixedFP &ads(const FixedFP &rhs)
   {
     C sum = value_ + rhs.value_;
 
@@ -142,128 +240,129 @@ public:
     return *this;
   }
 
-  inline FixedFP &operator-=(const FixedFP &rhs) {
-    value_ -= rhs.value_;
+  constexpr FixedFP &operator-=(const FixedFP &rhs) {
+    value_ = O::template sub<C, F>(value_, rhs.value_);
     return *this;
   }
 
-  inline FixedFP &operator*=(const FixedFP &rhs) {
+  constexpr FixedFP &operator*=(const FixedFP &rhs) {
 
-    value_ = static_cast<typename FixedFP<C, F>::template promote_type<C>::type>(value_)*rhs.value_ >> shift_;
+    using P = typename promote_type<C>::type;
+    value_ = O::template narrow<C, F>(static_cast<P>(static_cast<P>(value_) * rhs.value_ >> shift_));
     return *this;
   }
 
-  inline FixedFP &operator/=(const FixedFP &rhs) {
+  constexpr FixedFP &operator/=(const FixedFP &rhs) {
 
-    value_ = (static_cast<typename FixedFP<C, F>::template promote_type<C>::type>(value_) << shift_) / rhs.value_;
+    using P = typename promote_type<C>::type;
+    value_ = O::template narrow<C, F>(static_cast<P>((static_cast<P>(value_) << shift_) / rhs.value_));
     return *this;
   }
 
-  inline bool operator==(const FixedFP &rhs) const {
+  constexpr bool operator==(const FixedFP &rhs) const {
     return value_ == rhs.value_;
   }
 
-  inline bool operator!=(const FixedFP &rhs) const {
+  constexpr bool operator!=(const FixedFP &rhs) const {
     return value_ != rhs.value_;
   }
 
-  inline bool operator>(const FixedFP &rhs) const {
+  constexpr bool operator>(const FixedFP &rhs) const {
     return value_ > rhs.value_;
   }
 
-  inline bool operator<(const FixedFP &rhs) const {
+  constexpr bool operator<(const FixedFP &rhs) const {
     return value_ < rhs.value_;
   }
 
-  inline bool operator>=(const FixedFP &rhs) const {
+  constexpr bool operator>=(const FixedFP &rhs) const {
     return value_ >= rhs.value_;
   }
 
-  inline bool operator<=(const FixedFP &rhs) const {
+  constexpr bool operator<=(const FixedFP &rhs) const {
     return value_ <= rhs.value_;
   }
 
-  inline FixedFP operator+(const FixedFP& rhs)
+  constexpr FixedFP operator+(const FixedFP& rhs)
   {
     FixedFP result(*this);
     result += rhs;
     return result;
   }
 
-  inline FixedFP operator-(const FixedFP& rhs)
+  constexpr FixedFP operator-(const FixedFP& rhs)
   {
     FixedFP result(*this);
     result -= rhs;
     return result;
   }
 
-  inline FixedFP operator*(const FixedFP& rhs)
+  constexpr FixedFP operator*(const FixedFP& rhs)
   {
     FixedFP result(*this);
     result *= rhs;
     return result;
   }
 
-  inline FixedFP operator/(const FixedFP& rhs)
+  constexpr FixedFP operator/(const FixedFP& rhs)
   {
     FixedFP result(*this);
     result /= rhs;
     return result;
   }
 
-  inline FixedFP operator-() const
+  constexpr FixedFP operator-() const
   {
-    FixedFP result(*this);
-    result.value_ = -result.value_;
-    return result;
+    using P = typename promote_type<C>::type;
+    return fromValue(O::template narrow<C, F>(-static_cast<P>(value_)));
   }
 
-  inline friend FixedFP operator+(const FixedFP& lhs, const FixedFP& rhs)
+  friend constexpr FixedFP operator+(const FixedFP& lhs, const FixedFP& rhs)
   {
     FixedFP result(lhs);
     result += rhs;
     return result;
   }
 
-  inline friend FixedFP operator-(const FixedFP& lhs, const FixedFP& rhs)
+  friend constexpr FixedFP operator-(const FixedFP& lhs, const FixedFP& rhs)
   {
     FixedFP result(lhs);
     result -= rhs;
     return result;
   }
 
-  inline friend FixedFP operator*(const FixedFP& lhs, const FixedFP& rhs)
+  friend constexpr FixedFP operator*(const FixedFP& lhs, const FixedFP& rhs)
   {
     FixedFP result(lhs);
     result *= rhs;
     return result;
   }
 
-  inline friend FixedFP operator/(const FixedFP& lhs, const FixedFP& rhs)
+  friend constexpr FixedFP operator/(const FixedFP& lhs, const FixedFP& rhs)
   {
     FixedFP result(lhs);
     result /= rhs;
     return result;
   }
 
-  static FixedFP floor(const FixedFP &fp) {
+  static constexpr FixedFP floor(const FixedFP &fp) {
     FixedFP ret(fp);
     ret.value_ = (ret.value_&(~fracMask_));
     return ret;
   }
 
-  static FixedFP frac(const FixedFP &fp) {
+  static constexpr FixedFP frac(const FixedFP &fp) {
     FixedFP ret(fp);
     ret.value_ = (ret.value_&(fracMask_ | signMask_));
     return ret;
   }
 
-  static FixedFP square(const FixedFP& fp)
+  static constexpr FixedFP square(const FixedFP& fp)
   {
     return fp * fp;
   }
 
-  static FixedFP cube(const FixedFP& fp)
+  static constexpr FixedFP cube(const FixedFP& fp)
   {
     return fp * fp * fp;
   }
@@ -276,9 +375,9 @@ public:
 
 	C value_ ;
 
-	static const uint8_t shift_=F ;
-	static const C fracMask_=(1<<F)-1 ;
-	static const C signMask_=(1<<(sizeof(C)-1)) ;
+	static constexpr uint8_t shift_=F ;
+	static constexpr C fracMask_=(1<<F)-1 ;
+	static constexpr C signMask_=(1<<(sizeof(C)-1)) ;
 
 	// Promotion mechanism
 
@@ -323,46 +422,108 @@ public:
 	};
 } ;
 
+//! 1/d kept as a normalised multiplier and a shift, so that dividing by a
+//! value that rarely changes (a phase increment, a CV range) costs a widening
+//! multiply instead of a 64 bit division. The reciprocal itself can be far
+//! outside of the range of FixedFP<C,F>.
+//!
+//! The multiplier is truncated, so x * reciprocal(d) can differ from x / d by
+//! up to 2 LSB plus 2^-22 of the result (test/test_fixed.cpp checks this
+//! bound; the worst case it hits across sample_t is 4 LSB).
 template <typename C,uint8_t F>
-static FixedFP<C,F> abs(const FixedFP<C,F> &fp)
+class FixedReciprocal {
+  using promoted_t = typename FixedFP<C,F>::template promote_type<C>::type;
+
+public:
+  // 1/1
+  constexpr FixedReciprocal()
+  : FixedReciprocal(FixedFP<C,F>(1))
+  {}
+
+  explicit constexpr FixedReciprocal(const FixedFP<C,F>& d)
+  {
+    const bool negative = d.value_ < 0;
+    const promoted_t magnitude = negative ? -promoted_t(d.value_) : promoted_t(d.value_);
+    assert(magnitude != 0);
+
+    int bits = 0;
+    while ((magnitude >> bits) != 0)
+    {
+      bits++;
+    }
+    // Keeps the multiplier within [2^(N-3), 2^(N-2)] for an N bit container
+    shift_ = int(sizeof(C)) * 8 - 3 - F + bits;
+    multiplier_ = static_cast<C>((promoted_t(1) << (F + shift_)) / magnitude);
+    if (negative)
+    {
+      multiplier_ = -multiplier_;
+    }
+  }
+
+  template <typename O>
+  friend constexpr FixedFP<C,F,O> operator*(const FixedFP<C,F,O>& x, const FixedReciprocal& r)
+  {
+    return FixedFP<C,F,O>::fromValue(
+      O::template narrow<C, F>(static_cast<promoted_t>((promoted_t(x.value_) * r.multiplier_) >> r.shift_)));
+  }
+
+private:
+  C multiplier_ = 0;
+  int shift_ = 0;
+};
+
+template <typename C,uint8_t F,typename O>
+constexpr FixedReciprocal<C,F> reciprocal(const FixedFP<C,F,O>& x)
 {
-  return (fp < FixedFP<C,F>(0)) ? -fp : fp;
+  return FixedReciprocal<C,F>(FixedFP<C,F>(x));
 }
 
-template <typename C,uint8_t F>
-static FixedFP<C,F> max(const FixedFP<C,F> &fp1, const FixedFP<C,F> &fp2)
+template <typename C,uint8_t F,typename O>
+constexpr FixedFP<C,F,O> abs(const FixedFP<C,F,O> &fp)
+{
+  return (fp < FixedFP<C,F,O>(0)) ? -fp : fp;
+}
+
+template <typename C,uint8_t F,typename O>
+constexpr FixedFP<C,F,O> max(const FixedFP<C,F,O> &fp1, const FixedFP<C,F,O> &fp2)
 {
   return (fp1 < fp2) ? fp2 : fp1;
 }
 
-template <typename C,uint8_t F>
-static FixedFP<C,F> min(const FixedFP<C,F> &fp1, const FixedFP<C,F> &fp2)
+template <typename C,uint8_t F,typename O>
+constexpr FixedFP<C,F,O> min(const FixedFP<C,F,O> &fp1, const FixedFP<C,F,O> &fp2)
 {
   return (fp1 < fp2) ? fp1 : fp2;
 }
 
 typedef FixedFP<int32_t, 27> sample_t;
+typedef FixedReciprocal<int32_t, 27> sample_reciprocal_t;
+//! For stages that can overshoot, e.g. boosted shapes
+typedef FixedFP<int32_t, 27, Saturating> saturated_sample_t;
 
-template <typename C,uint8_t F>
-FixedFP<C,F> frac(const FixedFP<C,F>& x)
+static_assert(sample_t(-4).value_ == -(4 << 27), "FixedFP construction must be constexpr");
+static_assert(sample_t(0.25) * sample_t(-2) == sample_t(-0.5), "FixedFP arithmetic must be constexpr");
+
+template <typename C,uint8_t F,typename O>
+constexpr FixedFP<C,F,O> frac(const FixedFP<C,F,O>& x)
 {
-  return FixedFP<C,F>::frac(x);
+  return FixedFP<C,F,O>::frac(x);
 }
 
-template <typename C,uint8_t F>
-FixedFP<C,F> floor(const FixedFP<C,F>& x)
+template <typename C,uint8_t F,typename O>
+constexpr FixedFP<C,F,O> floor(const FixedFP<C,F,O>& x)
 {
-  return FixedFP<C,F>::floor(x);
+  return FixedFP<C,F,O>::floor(x);
 }
 
-template <typename C,uint8_t F>
-FixedFP<C,F> square(const FixedFP<C,F>& x)
+template <typename C,uint8_t F,typename O>
+constexpr FixedFP<C,F,O> square(const FixedFP<C,F,O>& x)
 {
-  return FixedFP<C,F>::square(x);
+  return FixedFP<C,F,O>::square(x);
 }
 
-template <typename C,uint8_t F>
-FixedFP<C,F> cube(const FixedFP<C,F>& x)
+template <typename C,uint8_t F,typename O>
+constexpr FixedFP<C,F,O> cube(const FixedFP<C,F,O>& x)
 {
-  return FixedFP<C,F>::sube(x);
+  return FixedFP<C,F,O>::cube(x);
 }
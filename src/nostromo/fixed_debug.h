@@ -0,0 +1,107 @@
+#pragma once
+
+// Host only, not part of the firmware build.
+
+#include "fixed.h"
+
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+
+//! Overflow policy that wraps like Wrapping but keeps statistics per site:
+//! how many operations overflowed, and the largest magnitude a result
+//! needed. Running an algorithm with e.g. FixedFP<int32_t, 27, OverflowCounting>
+//! on test signals then tells how many integer bits it needs, i.e. the
+//! cheapest Q format that is safe for it.
+//!
+//! Operations are attributed to the innermost live OverflowCounting::Site,
+//! which defaults to the name of the function declaring it:
+//!
+//!   void process() { OverflowCounting::Site site; ... }
+struct OverflowCounting
+{
+  struct Stats
+  {
+    uint32_t operations = 0;
+    uint32_t overflows = 0;
+    double peak = 0.;
+
+    //! Integer bits (sign excluded) that would have held every result
+    int integerBits() const
+    {
+      return (peak < 1.) ? 0 : int(std::floor(std::log2(peak))) + 1;
+    }
+  };
+
+  class Site
+  {
+  public:
+    explicit Site(const char* name = __builtin_FUNCTION())
+    : previous_(current())
+    {
+      current() = name;
+    }
+
+    ~Site()
+    {
+      current() = previous_;
+    }
+
+  private:
+    const char* previous_;
+  };
+
+  static std::map<std::string, Stats>& stats()
+  {
+    static std::map<std::string, Stats> stats;
+    return stats;
+  }
+
+  static void reset()
+  {
+    stats().clear();
+  }
+
+  static void report(FILE* out = stdout)
+  {
+    for (const auto& entry: stats())
+    {
+      const auto& s = entry.second;
+      fprintf(out, "%-32s %10u ops %8u overflows  peak %12.4f  needs %d integer bits\n",
+        entry.first.c_str(), s.operations, s.overflows, s.peak, s.integerBits());
+    }
+  }
+
+  template <typename C, uint8_t F>
+  static C add(const C& a, const C& b)
+  {
+    return narrow<C, F>(int64_t(a) + b);
+  }
+
+  template <typename C, uint8_t F>
+  static C sub(const C& a, const C& b)
+  {
+    return narrow<C, F>(int64_t(a) - b);
+  }
+
+  template <typename C, uint8_t F, typename P>
+  static C narrow(const P& wide)
+  {
+    auto& s = stats()[current()];
+    s.operations++;
+    if (wide > P(std::numeric_limits<C>::max()) || wide < P(std::numeric_limits<C>::min()))
+    {
+      s.overflows++;
+    }
+    s.peak = std::max(s.peak, std::fabs(double(wide) / double(int64_t(1) << F)));
+    return static_cast<C>(wide);
+  }
+
+private:
+  static const char*& current()
+  {
+    static const char* site = "(no site)";
+    return site;
+  }
+};
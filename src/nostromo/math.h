@@ -15,6 +15,13 @@ T clamp(const T& a,const T&low, const T&high)
 }
 
 
+//! Reciprocal to be multiplied by, see FixedReciprocal for fixed point
+template <typename T>
+T reciprocal(const T& x)
+{
+  return T(1) / x;
+}
+
 template <typename T>
 T frac(const T& x)
 {
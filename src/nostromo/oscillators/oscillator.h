@@ -26,6 +26,11 @@ public:
     ticker_ = ticker;
   }
 
+  const typename Phasor<T>::Reciprocal& phaseIncInverse() const
+  {
+    return phasor_.phaseIncInverse();
+  }
+
   T tick(const T& shape)
   {
     const auto phase = phasor_.tick();
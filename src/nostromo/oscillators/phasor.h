@@ -1,9 +1,15 @@
 #pragma once
 
+#include "../fastmath.h"
+#include "../fixed.h"
+#include "../math.h"
+
 template <typename T>
 class Phasor
 {
 public:
+  using Reciprocal = decltype(reciprocal(T()));
+
   Phasor()
   {};
 
@@ -17,8 +23,11 @@ public:
 
   void setFrequency(const float frequency)
   {
-    frequency_ = frequency;
-    updatePhaseInc();
+    if (frequency != frequency_)
+    {
+      frequency_ = frequency;
+      updatePhaseInc();
+    }
   }
 
   T tick()
@@ -34,6 +43,12 @@ public:
     return phaseIncrease_;
   }
 
+  //! For the band limited shapes, updated along with the frequency
+  const Reciprocal& phaseIncInverse() const
+  {
+    return phaseIncInverse_;
+  }
+
   bool flanked()
   {
     return flanked_;
@@ -43,13 +58,92 @@ private:
   void updatePhaseInc()
   {
     phaseIncrease_ = T(frequency_ / samplerate_);
+    if (phaseIncrease_ != T(0))
+    {
+      phaseIncInverse_ = reciprocal(phaseIncrease_);
+    }
   }
 
 private:
   T phase_;
   T phaseIncrease_;
+  Reciprocal phaseIncInverse_;
   T lastPhase_;
   bool flanked_;
   float frequency_ = 440.;
   float samplerate_ = kSampleRate;
 };
+
+//! Phasor tuned by a Hemisphere pitch CV (128 units per semitone), entirely
+//! in fixed point: whole octaves shift the increment and the fraction of an
+//! octave goes through the 2^x table of fastmath.
+class PitchPhasor
+{
+public:
+  static constexpr int kUnitsPerOctave = 12 << 7;
+
+  //! baseFrequency is the frequency at pitch 0
+  void reset(const float samplerate, const float baseFrequency)
+  {
+    phase_ = 0;
+    baseIncrease_ = sample_t(baseFrequency / samplerate);
+    pitch_ = 0;
+    phaseIncrease_ = baseIncrease_;
+  }
+
+  void setPitch(const int pitch)
+  {
+    if (pitch == pitch_)
+    {
+      return;
+    }
+    pitch_ = pitch;
+
+    int octave = pitch / kUnitsPerOctave;
+    int rest = pitch - octave * kUnitsPerOctave;
+    if (rest < 0)
+    {
+      rest += kUnitsPerOctave;
+      octave--;
+    }
+
+    const auto x = sample_t::fromValue(rest * ((1 << sample_t::shift_) / kUnitsPerOctave));
+    const auto increase = baseIncrease_ * fastmath::exp2(x);
+
+    // Clamped at Nyquist
+    const int32_t maxIncrease = 1 << (sample_t::shift_ - 1);
+    if (octave >= 0)
+    {
+      octave = std::min(octave, 30);
+      phaseIncrease_ = sample_t::fromValue(
+        (increase.value_ > (maxIncrease >> octave)) ? maxIncrease : increase.value_ << octave);
+    }
+    else
+    {
+      phaseIncrease_ = sample_t::fromValue(increase.value_ >> std::min(-octave, 31));
+    }
+  }
+
+  //! Restarts the cycle
+  void sync()
+  {
+    phase_ = 0;
+  }
+
+  sample_t tick()
+  {
+    phase_ = sample_t::frac(phase_ + phaseIncrease_);
+    return phase_;
+  }
+
+  sample_t phaseInc() const
+  {
+    return phaseIncrease_;
+  }
+
+private:
+  sample_t phase_;
+  sample_t phaseIncrease_;
+  sample_t baseIncrease_;
+  int pitch_ = 0;
+};
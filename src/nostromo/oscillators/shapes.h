@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../dsp.h"
+#include "../fastmath.h"
 #include "../random.h"
 
 // Basic Shapes
@@ -30,99 +31,106 @@ T triangle(const T& in)
 }
 
 // Band limited helpers
+//
+// invPhaseInc is reciprocal(phaseInc), cached by the caller along with the
+// increment: select() evaluates both of its branches, so dividing here would
+// cost several divisions per sample.
 
-template <typename T>
-T polyBlep1(const T& phase, const T& phaseInc, const T& discontinuity = T(0.5))
+template <typename T, typename R>
+T polyBlep1(const T& phase, const T& phaseInc, const R& invPhaseInc, const T& discontinuity = T(0.5))
 {
   auto result = T(0);
 
   result += select(
     (phase >= discontinuity) & (phase < (discontinuity + phaseInc)),
-    -square((phase - (discontinuity + phaseInc)) / phaseInc), T(0));
+    -square((phase - (discontinuity + phaseInc)) * invPhaseInc), T(0));
 
   result += select(
     (phase >= (discontinuity - phaseInc)) & (phase < discontinuity),
-    square((phase - (discontinuity - phaseInc)) / phaseInc), T(0));
+    square((phase - (discontinuity - phaseInc)) * invPhaseInc), T(0));
 
-  const auto normalisationScaling = T(0.5);
+  constexpr T normalisationScaling = T(0.5);
   return result * normalisationScaling;
 }
 
 //! The same as polyBlep1 but with a fixed discontinuity position at phase = 0|1
 
-template <typename T>
-T polyBlep1Fixed(const T& phase, const T& phaseInc)
+template <typename T, typename R>
+T polyBlep1Fixed(const T& phase, const T& phaseInc, const R& invPhaseInc)
 {
   auto result = T(0);
 
-  result += select(phase < phaseInc, -square(phase / phaseInc - T(1)), T(0));
+  result += select(phase < phaseInc, -square(phase * invPhaseInc - T(1)), T(0));
 
   result +=
-    select(phase > T(1) - phaseInc, square((phase - (T(1) - phaseInc)) / phaseInc), T(0));
+    select(phase > T(1) - phaseInc, square((phase - (T(1) - phaseInc)) * invPhaseInc), T(0));
 
-  const auto normalisationScaling = T(0.5);
+  constexpr T normalisationScaling = T(0.5);
   return result * normalisationScaling;
 }
 
-template <typename T>
-T polyBlamp2(const T& phase, const T& phaseInc, const T& discontinuity = T(0.5))
+template <typename T, typename R>
+T polyBlamp2(const T& phase, const T& phaseInc, const R& invPhaseInc, const T& discontinuity = T(0.5))
 {
   auto result = T(0);
 
   result += select(
     (phase >= discontinuity) & (phase < (discontinuity + phaseInc)),
-    -cube((phase - discontinuity) / phaseInc - T(1)), T(0));
+    -cube((phase - discontinuity) * invPhaseInc - T(1)), T(0));
 
   result += select(
     (phase >= (discontinuity - phaseInc)) & (phase < discontinuity),
-    cube((phase - discontinuity) / phaseInc + T(1)), T(0));
+    cube((phase - discontinuity) * invPhaseInc + T(1)), T(0));
 
-  const auto normalisationScaling = T(6);
-  return result / normalisationScaling;
+  constexpr T normalisationScaling = T(1. / 6.);
+  return result * normalisationScaling;
 }
 
 //! The same as polyBlamp2 but with a fixed discontinuity position at phase = 0|1
-template <typename T>
-T polyBlamp2Fixed(const T& phase, const T& phaseInc)
+template <typename T, typename R>
+T polyBlamp2Fixed(const T& phase, const T& phaseInc, const R& invPhaseInc)
 {
   auto result = T(0);
 
-  result += select(phase < phaseInc, -cube(phase / phaseInc - T(1)), T(0));
-  result += select(phase > T(1) - phaseInc, cube((phase - T(1)) / phaseInc + T(1)), T(0));
+  result += select(phase < phaseInc, -cube(phase * invPhaseInc - T(1)), T(0));
+  result += select(phase > T(1) - phaseInc, cube((phase - T(1)) * invPhaseInc + T(1)), T(0));
 
-  const auto normalisationScaling = T(6);
-  return result / normalisationScaling;
+  constexpr T normalisationScaling = T(1. / 6.);
+  return result * normalisationScaling;
 }
 
+static_assert(sample_t(1. / 6.).value_ == int32_t((1 << 27) / 6.),
+  "FixedFP construction must fold at compile time");
+
 // Band limited Shapes
 
-template <typename T>
-T rectPolyBlep(const T& phase, const T& phaseIncrement, const T& midPoint = T(0.5))
+template <typename T, typename R>
+T rectPolyBlep(const T& phase, const T& phaseIncrement, const R& invPhaseIncrement, const T& midPoint = T(0.5))
 {
   //  The BLEP residual is scaled by the height of the step.
-  const auto stepScaling = T(2);
+  constexpr T stepScaling = T(2);
 
   //  Discontinuities occur at 0 and midPoint.
-  return rect(phase, midPoint) + stepScaling * polyBlep1Fixed(phase, phaseIncrement)
-         - stepScaling * polyBlep1(phase, phaseIncrement, midPoint);
+  return rect(phase, midPoint) + stepScaling * polyBlep1Fixed(phase, phaseIncrement, invPhaseIncrement)
+         - stepScaling * polyBlep1(phase, phaseIncrement, invPhaseIncrement, midPoint);
 }
 
-template <typename T>
-T sawPolyBlep(const T& phase, const T& phaseIncrement)
+template <typename T, typename R>
+T sawPolyBlep(const T& phase, const T& phaseIncrement, const R& invPhaseIncrement)
 {
   // The BLEP residual is scaled by the height of the step
-  const auto stepScaling = T(2);
-  return saw(phase) - stepScaling * polyBlep1(phase, phaseIncrement, T(0.5));
+  constexpr T stepScaling = T(2);
+  return saw(phase) - stepScaling * polyBlep1(phase, phaseIncrement, invPhaseIncrement, T(0.5));
 }
 
-template <typename T>
-T trianglePolyBlamp(const T& phase, const T& phaseIncrement)
+template <typename T, typename R>
+T trianglePolyBlamp(const T& phase, const T& phaseIncrement, const R& invPhaseIncrement)
 {
   const auto slopeScaling = phaseIncrement * T(8);
 
   //  Discontinuities occur at 0.25 and 0.75
-  return triangle(phase) - slopeScaling * polyBlamp2(phase, phaseIncrement, T(0.25))
-         + slopeScaling * polyBlamp2(phase, phaseIncrement, T(0.75));
+  return triangle(phase) - slopeScaling * polyBlamp2(phase, phaseIncrement, invPhaseIncrement, T(0.25))
+         + slopeScaling * polyBlamp2(phase, phaseIncrement, invPhaseIncrement, T(0.75));
 }
 
 template <typename T>
@@ -136,3 +144,9 @@ T tanh(const T& phase)
   };
   return tanhApprox(triangle(phase)*T(2));
 }
+
+//! Same shape from the fastmath table, without the division per sample
+inline sample_t tanh(const sample_t& phase)
+{
+  return fastmath::tanh(triangle(phase) * sample_t(2));
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "../fastmath.h"
+#include "../fixed.h"
+
+#include <algorithm>
+#include <cstdint>
+
+//! One cycle of a waveform, stored as band-limited mip levels one octave
+//! apart: level n keeps the harmonics below kSize / 2 >> n. The basic tables
+//! are computed by the compiler from the sine series of the waveform, so they
+//! sit in flash; user cycles are built at runtime in fixed point. Reading
+//! costs the same whatever the waveform and pitch.
+class Wavetable
+{
+public:
+  static constexpr int kSizeBits = 7;
+  static constexpr int kSize = 1 << kSizeBits;
+  //! From 63 harmonics down to the fundamental alone
+  static constexpr int kLevels = kSizeBits;
+
+  constexpr Wavetable() : levels_{} {}
+
+  //! Builds the levels from the amplitude of each harmonic, for a waveform
+  //! made of sines only: sum of harmonic(k) * sin(2 pi k p), valued in [-1,1]
+  static constexpr Wavetable fromHarmonics(double (*harmonic)(int))
+  {
+    double sine[kSize] = {};
+    for (int n = 0; n < kSize; n++)
+    {
+      sine[n] = fastmath::detail::sinCycle(double(n) / kSize);
+    }
+
+    // Resynthesis, dropping an octave of harmonics per level
+    Wavetable table;
+    for (int level = 0; level < kLevels; level++)
+    {
+      const int harmonics = (level == 0) ? kHarmonics : (kSize / 2) >> level;
+      for (int n = 0; n < kSize; n++)
+      {
+        double value = 0.;
+        for (int k = 1; k <= harmonics; k++)
+        {
+          value += harmonic(k) * sine[(k * n) & kMask];
+        }
+        value *= double(1 << kOneBits);
+        value = (value > 32767.) ? 32767. : (value < -32767.) ? -32767. : value;
+        table.levels_[level][n] = int16_t(value + ((value >= 0.) ? 0.5 : -0.5));
+      }
+      table.levels_[level][kSize] = table.levels_[level][0];
+    }
+    return table;
+  }
+
+  //! Builds the levels at runtime from kSize samples of a cycle in Q14, i.e.
+  //! one is 1 << 14, without any float: a DFT of the cycle, then a
+  //! resynthesis per level. About 50K multiply-adds, so for the main loop.
+  void build(const int16_t* cycle)
+  {
+    // sin(2 pi n / kSize) in Q15
+    int32_t sine[kSize];
+    for (int n = 0; n < kSize; n++)
+    {
+      const auto phase = sample_t::fromValue(int32_t(n) << (sample_t::shift_ - kSizeBits));
+      sine[n] = fastmath::sin(phase).value_ >> (sample_t::shift_ - 15);
+    }
+
+    // Analysis, coefficients in Q20
+    int32_t sum = 0;
+    for (int n = 0; n < kSize; n++)
+    {
+      sum += cycle[n];
+    }
+    const int32_t dc = (sum << (kCoefficientBits - kOneBits)) >> kSizeBits;
+
+    int32_t re[kHarmonics + 1];
+    int32_t im[kHarmonics + 1];
+    for (int k = 1; k <= kHarmonics; k++)
+    {
+      int64_t a = 0;
+      int64_t b = 0;
+      for (int n = 0; n < kSize; n++)
+      {
+        const int index = (k * n) & kMask;
+        a += int64_t(cycle[n]) * sine[(index + kCosineOffset) & kMask];
+        b += int64_t(cycle[n]) * sine[index];
+      }
+      // 2 / kSize of the Q29 sums
+      const int shift = kOneBits + 15 + kSizeBits - 1 - kCoefficientBits;
+      re[k] = int32_t(a >> shift);
+      im[k] = int32_t(b >> shift);
+    }
+
+    // Resynthesis, dropping an octave of harmonics per level
+    for (int level = 0; level < kLevels; level++)
+    {
+      const int harmonics = (level == 0) ? kHarmonics : (kSize / 2) >> level;
+      for (int n = 0; n < kSize; n++)
+      {
+        int64_t value = int64_t(dc) << 15;
+        for (int k = 1; k <= harmonics; k++)
+        {
+          const int index = (k * n) & kMask;
+          value += int64_t(re[k]) * sine[(index + kCosineOffset) & kMask] + int64_t(im[k]) * sine[index];
+        }
+        const int32_t sample = int32_t(value >> (kCoefficientBits + 15 - kOneBits));
+        levels_[level][n] = int16_t(std::max(std::min(sample, int32_t(32767)), int32_t(-32767)));
+      }
+      levels_[level][kSize] = levels_[level][0];
+    }
+  }
+
+  //! Builds the levels at runtime from a cycle of linear segments, as the
+  //! vector oscillator's: each one ramps from the level of the previous one
+  //! (the last one for the first) to its own during its share of the total
+  //! time. Levels are unsigned bytes centered on 128.
+  template <typename Segment>
+  void buildFromSegments(const Segment* segments, int count)
+  {
+    int total = 0;
+    for (int i = 0; i < count; i++)
+    {
+      total += segments[i].time;
+    }
+
+    int16_t cycle[kSize] = {};
+    if (total > 0)
+    {
+      // Positions in time units times kSize, to stay in integers
+      int segment = 0;
+      int start = 0;
+      for (int n = 0; n < kSize; n++)
+      {
+        const int position = n * total;
+        while (position >= start + segments[segment].time * kSize)
+        {
+          start += segments[segment].time * kSize;
+          segment++;
+        }
+        const int from = segmentLevel(segments[(segment > 0) ? segment - 1 : count - 1].level);
+        const int to = segmentLevel(segments[segment].level);
+        cycle[n] = int16_t(from + (to - from) * (position - start) / (segments[segment].time * kSize));
+      }
+    }
+    build(cycle);
+  }
+
+  //! Reads at phase, crossfading between the two lowest mip levels that do
+  //! not alias at phaseInc
+  sample_t read(const sample_t& phase, const sample_t& phaseInc) const
+  {
+    const uint32_t p = uint32_t(phase.value_) & sample_t::fracMask_;
+    const uint32_t increment = uint32_t(std::max(phaseInc.value_, int32_t(1)));
+
+    // Level n is alias free below an increment of 2^(n - kSizeBits): the
+    // octave of the increment picks the lowest safe level, and the position
+    // within the octave the crossfade to the next one.
+    const int msb = 31 - __builtin_clz(increment);
+    const int level = msb - (sample_t::shift_ - kSizeBits - 1);
+
+    int32_t value;
+    if (level < 0)
+    {
+      value = readLevel(0, p);
+    }
+    else if (level >= kLevels - 1)
+    {
+      value = readLevel(kLevels - 1, p);
+    }
+    else
+    {
+      const int32_t fade = (increment >> (msb - 8)) & 0xff;
+      const int32_t low = readLevel(level, p);
+      const int32_t high = readLevel(level + 1, p);
+      value = low + (((high - low) * fade) >> 8);
+    }
+    return sample_t::fromValue(value << (sample_t::shift_ - kOneBits));
+  }
+
+private:
+  static constexpr int kMask = kSize - 1;
+  static constexpr int kHarmonics = kSize / 2 - 1;
+  // Samples are Q14, leaving headroom for the band-limiting overshoot
+  static constexpr int kOneBits = 14;
+  // Harmonic amplitudes of runtime builds are Q20
+  static constexpr int kCoefficientBits = 20;
+  // cos(x) is read from the sine table a quarter of a cycle later
+  static constexpr int kCosineOffset = kSize / 4;
+
+  static int32_t segmentLevel(uint8_t level)
+  {
+    return ((int32_t(level) - 128) << kOneBits) / 127;
+  }
+
+  int32_t readLevel(int level, uint32_t phase) const
+  {
+    const int indexShift = sample_t::shift_ - kSizeBits;
+    const int16_t* table = levels_[level];
+    const uint32_t index = phase >> indexShift;
+    const int32_t fraction = (phase >> (indexShift - 15)) & 0x7fff;
+    const int32_t a = table[index];
+    const int32_t b = table[index + 1];
+    return a + (((b - a) * fraction) >> 15);
+  }
+
+  // One guard sample per level for the interpolation
+  int16_t levels_[kLevels][kSize + 1];
+};
+
+namespace wavetables
+{
+  enum class Shapes
+  {
+    Saw,
+    Square,
+    Triangle,
+    COUNT
+  };
+
+  namespace detail
+  {
+    // Sine series of the basic shapes of shapes.h
+
+    constexpr double sawHarmonic(int k)
+    {
+      return ((k & 1) ? 2. : -2.) / (fastmath::detail::kPi * k);
+    }
+
+    constexpr double squareHarmonic(int k)
+    {
+      return (k & 1) ? 4. / (fastmath::detail::kPi * k) : 0.;
+    }
+
+    constexpr double triangleHarmonic(int k)
+    {
+      return (k & 1) ? ((k & 2) ? -8. : 8.) / (fastmath::detail::kPi * fastmath::detail::kPi * k * k) : 0.;
+    }
+
+    constexpr Wavetable kTables[int(Shapes::COUNT)] =
+    {
+      Wavetable::fromHarmonics(sawHarmonic),
+      Wavetable::fromHarmonics(squareHarmonic),
+      Wavetable::fromHarmonics(triangleHarmonic),
+    };
+  }
+
+  //! Band-limited basic shapes, shared by everyone
+  inline const Wavetable& get(Shapes shape)
+  {
+    return detail::kTables[int(shape)];
+  }
+
+  //! The one table built at runtime from a user cycle, shared by everyone
+  inline Wavetable& user()
+  {
+    static Wavetable table;
+    return table;
+  }
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "fixed.h"
+
+#include <cstdint>
+
+#if defined(KINETISK)
+#include "../../extern/dspinst.h"
+#endif
+
+//! Two Q15 values in one word, one lane per channel of a hemisphere (lane 0,
+//! channel A, in the bottom half). On the Cortex-M4 each operation handles
+//! both lanes with a single SIMD instruction, elsewhere it falls back to
+//! plain C so that the same code runs on the host.
+class Q15x2
+{
+public:
+  constexpr Q15x2()
+  : packed_(0)
+  {}
+
+  static constexpr Q15x2 fromPacked(uint32_t packed)
+  {
+    return Q15x2(packed);
+  }
+
+  static constexpr Q15x2 fromLanes(int16_t a, int16_t b)
+  {
+    return Q15x2((uint32_t(uint16_t(b)) << 16) | uint16_t(a));
+  }
+
+  //! Saturated to [-1, 1)
+  static Q15x2 fromSamples(const sample_t& a, const sample_t& b)
+  {
+    return fromLanes(saturate(a.value_ >> kSampleShift), saturate(b.value_ >> kSampleShift));
+  }
+
+  constexpr uint32_t packed() const
+  {
+    return packed_;
+  }
+
+  constexpr int16_t lane(int index) const
+  {
+    return int16_t(packed_ >> (16 * index));
+  }
+
+  sample_t sample(int index) const
+  {
+    return sample_t::fromValue(int32_t(lane(index)) << kSampleShift);
+  }
+
+  //! Saturating (QADD16)
+  friend Q15x2 operator+(const Q15x2& x, const Q15x2& y)
+  {
+#if defined(KINETISK)
+    return fromPacked(signed_add_16_and_16(x.packed_, y.packed_));
+#else
+    return fromLanes(saturate(int32_t(x.lane(0)) + y.lane(0)), saturate(int32_t(x.lane(1)) + y.lane(1)));
+#endif
+  }
+
+  //! Saturating (QSUB16)
+  friend Q15x2 operator-(const Q15x2& x, const Q15x2& y)
+  {
+#if defined(KINETISK)
+    return fromPacked(signed_subtract_16_and_16(x.packed_, y.packed_));
+#else
+    return fromLanes(saturate(int32_t(x.lane(0)) - y.lane(0)), saturate(int32_t(x.lane(1)) - y.lane(1)));
+#endif
+  }
+
+  //! Lane by lane product (SMULBB, SMULTT), saturated so -1 * -1 stays in range
+  friend Q15x2 operator*(const Q15x2& x, const Q15x2& y)
+  {
+#if defined(KINETISK)
+    const int32_t low = signed_saturate_rshift(multiply_16bx16b(x.packed_, y.packed_), 16, 15);
+    const int32_t high = signed_saturate_rshift(multiply_16tx16t(x.packed_, y.packed_), 16, 15);
+    return fromPacked(pack_16b_16b(high, low));
+#else
+    return fromLanes(saturate((int32_t(x.lane(0)) * y.lane(0)) >> 15),
+      saturate((int32_t(x.lane(1)) * y.lane(1)) >> 15));
+#endif
+  }
+
+  //! Lane by lane, wrapping around instead of saturating, for phases
+  friend Q15x2 wrappingAdd(const Q15x2& x, const Q15x2& y)
+  {
+    // Adds the low 15 bits of both lanes without carry between them, then
+    // the top bits without carry at all
+    const uint32_t low = (x.packed_ & 0x7fff7fff) + (y.packed_ & 0x7fff7fff);
+    return fromPacked(low ^ ((x.packed_ ^ y.packed_) & 0x80008000));
+  }
+
+  //! Sum of the lane products in Q30, e.g. the two channels mixed by the
+  //! lanes of weights (SMUAD)
+  int32_t dot(const Q15x2& weights) const
+  {
+#if defined(KINETISK)
+    return multiply_16tx16t_add_16bx16b(packed_, weights.packed_);
+#else
+    return int32_t(lane(0)) * weights.lane(0) + int32_t(lane(1)) * weights.lane(1);
+#endif
+  }
+
+  //! sum + dot(weights), to mix several pairs (SMLAD)
+  int32_t dotAccumulate(int32_t sum, const Q15x2& weights) const
+  {
+#if defined(KINETISK)
+    return multiply_accumulate_32_16tx16t_add_16bx16b(sum, packed_, weights.packed_);
+#else
+    return sum + dot(weights);
+#endif
+  }
+
+private:
+  static constexpr int kSampleShift = sample_t::shift_ - 15;
+
+  explicit constexpr Q15x2(uint32_t packed)
+  : packed_(packed)
+  {}
+
+  static int16_t saturate(int32_t value)
+  {
+    return int16_t(value > INT16_MAX ? INT16_MAX : value < INT16_MIN ? INT16_MIN : value);
+  }
+
+  uint32_t packed_;
+};
+
+//------------------------------------------------------------------------------
+
+//! Two phase accumulators, each lane wrapping over its whole range, which
+//! makes the phase itself a bipolar saw
+class Phasor2
+{
+public:
+  void reset()
+  {
+    phase_ = Q15x2();
+  }
+
+  //! Increment in cycles per tick
+  void setIncrement(int lane, const sample_t& increment)
+  {
+    // A cycle is 2^16 in a lane
+    const int16_t value = int16_t(increment.value_ >> (sample_t::shift_ - 16));
+    increment_ = (lane == 0)
+      ? Q15x2::fromLanes(value, increment_.lane(1))
+      : Q15x2::fromLanes(increment_.lane(0), value);
+  }
+
+  Q15x2 tick()
+  {
+    phase_ = wrappingAdd(phase_, increment_);
+    return phase_;
+  }
+
+private:
+  Q15x2 phase_;
+  Q15x2 increment_;
+};
+
+//! Two one-pole slews sharing a coefficient, as Slew<T> does for a channel
+class Slew2
+{
+public:
+  void init(const Q15x2& value)
+  {
+    value_ = value;
+  }
+
+  //! Portion of the remaining distance kept at each tick, in [0, 1)
+  void setCoefficient(const sample_t& coeff)
+  {
+    coeff_ = Q15x2::fromSamples(coeff, coeff);
+  }
+
+  //! The distance to the target saturates, so values should stay in [-0.5, 0.5)
+  //! for an exact response
+  Q15x2 tick(const Q15x2& target)
+  {
+    value_ = target + (value_ - target) * coeff_;
+    return value_;
+  }
+
+  Q15x2 value() const
+  {
+    return value_;
+  }
+
+private:
+  Q15x2 value_;
+  Q15x2 coeff_;
+};
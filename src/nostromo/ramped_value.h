@@ -1,5 +1,7 @@
 #pragma once
 
+#include "fixed.h"
+
 #include <cstdint>
 
 template <typename T>
@@ -74,3 +76,129 @@ private:
   std::uint64_t mTicksToCompletion;
   std::uint64_t mDurationInTicks;
 };
+
+namespace detail
+{
+  template <typename T>
+  T rampIncrement(const T& from, const T& to, const std::uint32_t ticks)
+  {
+    return (to - from) / T(ticks);
+  }
+
+  // On the raw values: T(ticks) would not fit most fixed point formats, and
+  // the distance across the whole range needs one more bit than the values
+  template <typename C, uint8_t F, typename O>
+  FixedFP<C, F, O> rampIncrement(const FixedFP<C, F, O>& from, const FixedFP<C, F, O>& to, const std::uint32_t ticks)
+  {
+    return FixedFP<C, F, O>::fromValue(C((int64_t(to.value_) - from.value_) / int64_t(ticks)));
+  }
+}
+
+//! As RampedValue, with 32 bit counters and no multiply per tick: the
+//! increment is accumulated and the last tick lands exactly on the target.
+template <typename T>
+class RampedValue32
+{
+public:
+  explicit RampedValue32(const T& value = T(0))
+    : mCurrent(value)
+    , mTarget(value)
+    , mIncrement(T(0))
+    , mTicksToCompletion(0u)
+    , mDurationInTicks(0u)
+  {
+  }
+
+  void setValue(const T& value)
+  {
+    mCurrent = value;
+    mTarget = value;
+    mTicksToCompletion = 0u;
+    mDurationInTicks = 0u;
+  }
+
+  void rampTo(const T& target, const std::uint32_t ticksToCompletion)
+  {
+    mTarget = target;
+    mDurationInTicks = ticksToCompletion;
+
+    if (ticksToCompletion <= 1u || mTarget == mCurrent)
+    {
+      mCurrent = target;
+      mTicksToCompletion = 0u;
+    }
+    else
+    {
+      mTicksToCompletion = ticksToCompletion - 1u;
+      mIncrement = detail::rampIncrement(mCurrent, mTarget, mTicksToCompletion);
+    }
+  }
+
+  bool isRamping() const { return mTicksToCompletion > 0u; }
+
+  T value() const { return mCurrent; }
+
+  T targetValue() const { return mTarget; }
+
+  T tick()
+  {
+    const auto result = mCurrent;
+
+    if (mTicksToCompletion > 0u)
+    {
+      --mTicksToCompletion;
+      mCurrent = (mTicksToCompletion == 0u) ? mTarget : mCurrent + mIncrement;
+    }
+
+    return result;
+  }
+
+  std::uint32_t durationInTicks() const { return mDurationInTicks; }
+
+  std::uint32_t ticksToCompletion() const { return mTicksToCompletion; }
+
+private:
+  T mCurrent;
+  T mTarget;
+  T mIncrement;
+  std::uint32_t mTicksToCompletion;
+  std::uint32_t mDurationInTicks;
+};
+
+//! A setting written by a property callback and read in the ISR, which
+//! ramps to each new setting so that encoder moves don't step. set() only
+//! stores the setting, the ramp itself is only touched by tick().
+template <typename T>
+class DezipperedValue
+{
+public:
+  //! About 8ms at the core rate
+  static constexpr std::uint32_t kRampTicks = 128u;
+
+  void set(const T& setting)
+  {
+    mSetting = setting;
+  }
+
+  //! Jumps to the setting, e.g. when an applet starts
+  void reset()
+  {
+    mRamp.setValue(mSetting);
+  }
+
+  T tick()
+  {
+    const T setting = mSetting;
+    if (setting != mRamp.targetValue())
+    {
+      mRamp.rampTo(setting, kRampTicks);
+    }
+    return mRamp.tick();
+  }
+
+  T value() const { return mRamp.value(); }
+
+private:
+  T mSetting = T(0);
+  RampedValue32<T> mRamp;
+};
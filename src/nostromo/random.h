@@ -2,6 +2,8 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <time.h>
 
 // ported from https://github.com/MKlimenko/random/
@@ -53,5 +55,100 @@ float Random<float>::tick()
 template <>
 sample_t Random<sample_t>::tick()
 {
-	return sample_t::fromRatio((tickInternal() & 0x3FFFFFFF) >> 15, 32767);
+	return sample_t::fromRatioPow2((tickInternal() & 0x3FFFFFFF) >> 15, 15);
+}
+
+//------------------------------------------------------------------------------
+// Counter-based generator: the value at any index is a hash of (key, index),
+// so sequences can be restarted, seeked or addressed at random without
+// replaying them. Uses Widynski's "Squares" counter-based RNG (32-bit output),
+// which unlike the LCG above has good quality in all bits.
+
+template <typename T>
+class CounterRandom {
+
+public:
+	CounterRandom()
+	{
+		seed(0x12345);
+	}
+
+	// Sets the key and restarts the sequence
+	void seed(std::uint32_t init)
+	{
+		// Spread the seed over a 64-bit odd key (splitmix64 finalizer)
+		std::uint64_t z = std::uint64_t(init) + 0x9e3779b97f4a7c15ull;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		key_ = (z ^ (z >> 31)) | 1;
+		index_ = 0;
+	}
+
+	void seek(std::uint32_t index)
+	{
+		index_ = index;
+	}
+
+	std::uint32_t position() const
+	{
+		return index_;
+	}
+
+	// Value at any index, without moving the current position
+	T at(std::uint32_t index) const
+	{
+		return convert(hash(index));
+	}
+
+	// Next value in the sequence
+	T tick()
+	{
+		return convert(hash(index_++));
+	}
+
+	// Fills a block with the next count values of the sequence
+	void generate(T* out, std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			out[i] = convert(hash(index_ + i));
+		}
+		index_ += count;
+	}
+
+private:
+	static T convert(std::uint32_t value);
+
+	std::uint32_t hash(std::uint32_t index) const
+	{
+		std::uint64_t x = std::uint64_t(index) * key_;
+		const std::uint64_t y = x;
+		const std::uint64_t z = y + key_;
+		x = x * x + y; x = (x >> 32) | (x << 32);
+		x = x * x + z; x = (x >> 32) | (x << 32);
+		x = x * x + y; x = (x >> 32) | (x << 32);
+		return (x * x + z) >> 32;
+	}
+
+	std::uint64_t key_;
+	std::uint32_t index_ = 0;
+};
+
+template <>
+inline uint32_t CounterRandom<uint32_t>::convert(std::uint32_t value)
+{
+	return value;
+}
+
+// Output range of float is [0, 1] and of sample_t [0, 1), as for Random<T>
+template <>
+inline float CounterRandom<float>::convert(std::uint32_t value)
+{
+	return (value >> 17) / 32767.f;
+}
+
+template <>
+inline sample_t CounterRandom<sample_t>::convert(std::uint32_t value)
+{
+	return sample_t::fromRatioPow2(value >> 17, 15);
 }
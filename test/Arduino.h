@@ -0,0 +1,12 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core and the sketch's implicit
+// includes that the tested headers rely on
+
+#include <array>
+#include <functional>
+#include <string>
+
+#define F_CPU 120000000
+
+using String = std::string;
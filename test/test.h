@@ -0,0 +1,35 @@
+#pragma once
+
+// Minimal checks for the host tests, see Makefile
+
+#include <chrono>
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+  do { \
+    if (!(condition)) { \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      ++failures; \
+    } \
+  } while (0)
+
+//! Nanoseconds per call of fn, only meant to compare alternatives on the host
+template <typename Fn>
+double nanosecondsPerCall(int calls, Fn fn)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < calls; i++)
+  {
+    fn(i);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / calls;
+}
+
+inline int finish(const char* name)
+{
+  printf("%s: %s\n", name, failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,117 @@
+#include "Arduino.h"
+#include "test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+// Just enough of the Hemisphere framework to drive ArticCircleApplet's
+// Controller() from the host: inputs are set per simulated ISR
+#define ForEachChannel(ch) for (int ch = 0; ch < 2; ch++)
+#define HEMISPHERE_MAX_CV 7680
+enum { HEMISPHERE_HELP_DIGITALS, HEMISPHERE_HELP_CVS, HEMISPHERE_HELP_OUTS, HEMISPHERE_HELP_ENCODER };
+
+namespace OC
+{
+  enum DigitalInput { DIGITAL_INPUT_1, DIGITAL_INPUT_2, DIGITAL_INPUT_3, DIGITAL_INPUT_4 };
+
+  struct DigitalInputs
+  {
+    static uint32_t clocked(DigitalInput input)
+    {
+      return physical[input];
+    }
+
+    static bool physical[4];
+  };
+
+  bool DigitalInputs::physical[4];
+}
+
+class HemisphereApplet
+{
+public:
+  bool Gate(int ch) { return gate[ch]; }
+  bool Clock(int ch) { return clock[ch]; }
+  bool Changed(int ch) { return changed[ch]; }
+
+  void gfxHeader(const char*) {}
+  void gfxPrint(int, int, const char*) {}
+  void gfxRect(int, int, int, int) {}
+  void gfxInvert(int, int, int, int) {}
+
+  bool gate[2] = {};
+  bool clock[2] = {};
+  bool changed[2] = {};
+
+protected:
+  bool hemisphere = 0;
+  const char* help[4];
+};
+
+#include "../src/nostromo/fixed.h"
+#include "../src/nostromo/applet/applet.h"
+
+struct Model
+{
+  using Properties = PropertySet<>;
+};
+
+// Counts what each tick() sees
+class Divided: public ArticCircleApplet<Model>
+{
+public:
+  explicit Divided(int divider)
+  {
+    setControlRateDivider(divider);
+  }
+
+  void tick() final
+  {
+    ++ticks;
+    flanks += flankUp(0) ? 1 : 0;
+    clocks += Clock(0) ? 1 : 0;
+    physicalClocks += Clock(0, true) ? 1 : 0;
+    changes += Changed(0) ? 1 : 0;
+  }
+
+  int ticks = 0;
+  int flanks = 0;
+  int clocks = 0;
+  int physicalClocks = 0;
+  int changes = 0;
+};
+
+int main()
+{
+  constexpr int kDivider = 4;
+  Divided applet(kDivider);
+  applet.Start();
+
+  CHECK(applet.controlRate() == kSampleRate / kDivider);
+
+  // One ISR long events mostly fall between the applet's ticks, yet each one
+  // must reach exactly one tick. None in the last period, which would still
+  // be pending at the end.
+  constexpr int kIsrs = 1000;
+  constexpr int kPeriod = 2 * kDivider + 1;
+  int events = 0;
+  for (int isr = 0; isr < kIsrs; isr++)
+  {
+    const bool event = (isr % kPeriod) == 0 && isr < kIsrs - kDivider;
+    events += event ? 1 : 0;
+    applet.gate[0] = event;
+    applet.clock[0] = event;
+    applet.changed[0] = event;
+    OC::DigitalInputs::physical[0] = event;
+    applet.Controller();
+  }
+
+  CHECK(applet.ticks == kIsrs / kDivider);
+  CHECK(applet.flanks == events);
+  CHECK(applet.clocks == events);
+  CHECK(applet.physicalClocks == events);
+  CHECK(applet.changes == events);
+
+  return finish("applet");
+}
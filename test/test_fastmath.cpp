@@ -0,0 +1,67 @@
+#include "test.h"
+#include "src/nostromo/fixed.h"
+#include "src/nostromo/fastmath.h"
+
+#include <cmath>
+
+// Worst error of fn over [from, to), sampled on every n-th sample_t value
+template <typename Fn>
+double worstError(double from, double to, int32_t stride, Fn error)
+{
+  double worst = 0.;
+  const int32_t end = int32_t(to * (1 << sample_t::shift_));
+  for (int64_t v = int64_t(from * (1 << sample_t::shift_)); v < end; v += stride)
+  {
+    worst = std::fmax(worst, error(sample_t::fromValue(int32_t(v))));
+  }
+  return worst;
+}
+
+int main()
+{
+  const double kTwoPi = 2. * M_PI;
+  const int32_t kStride = 97;
+
+  // The documented error bounds hold over each function's domain
+
+  const double sinError = worstError(0., 1., kStride, [&](sample_t x) {
+    return std::fabs(double(float(fastmath::sin(x))) - std::sin(kTwoPi * double(float(x))));
+  });
+  printf("sin: %g (max %g)\n", sinError, fastmath::kSinMaxError);
+  CHECK(sinError <= fastmath::kSinMaxError);
+
+  const double exp2Error = worstError(-8., 4., kStride * 16, [&](sample_t x) {
+    const double expected = std::exp2(double(x.value_) / (1 << sample_t::shift_));
+    const double value = double(fastmath::exp2(x).value_) / (1 << sample_t::shift_);
+    return (value == float(sample_t::SMax())) ? 0. : std::fabs(value - expected) / expected;
+  });
+  printf("exp2: %g (max %g)\n", exp2Error, fastmath::kExp2MaxError);
+  CHECK(exp2Error <= fastmath::kExp2MaxError);
+
+  const double log2Error = worstError(1. / 65536., 15.99, kStride * 16, [&](sample_t x) {
+    const double expected = std::log2(double(x.value_) / (1 << sample_t::shift_));
+    return std::fabs(double(fastmath::log2(x).value_) / (1 << sample_t::shift_) - expected);
+  });
+  printf("log2: %g (max %g)\n", log2Error, fastmath::kLog2MaxError);
+  CHECK(log2Error <= fastmath::kLog2MaxError);
+
+  const double tanhError = worstError(-15.99, 15.99, kStride * 16, [&](sample_t x) {
+    const double expected = std::tanh(double(x.value_) / (1 << sample_t::shift_));
+    return std::fabs(double(fastmath::tanh(x).value_) / (1 << sample_t::shift_) - expected);
+  });
+  printf("tanh: %g (max %g)\n", tanhError, fastmath::kTanhMaxError);
+  CHECK(tanhError <= fastmath::kTanhMaxError);
+
+  double inverseError = 0.;
+  for (double x = 1.; x < 1e4; x *= 1.0001)
+  {
+    const uint64_t value = uint64_t(x * (1 << sample_t::shift_));
+    const double expected = double(1 << sample_t::shift_) / double(value);
+    const double error = std::fabs(double(fastmath::inverse(value).value_) / (1 << sample_t::shift_) - expected);
+    inverseError = std::fmax(inverseError, error);
+  }
+  printf("inverse: %g (max %g)\n", inverseError, fastmath::kInverseMaxError);
+  CHECK(inverseError <= fastmath::kInverseMaxError);
+
+  return finish("fastmath");
+}
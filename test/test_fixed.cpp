@@ -0,0 +1,51 @@
+#include "test.h"
+#include "src/nostromo/fixed.h"
+
+#include <cmath>
+#include <cstdlib>
+
+static volatile int32_t sink;
+
+int main()
+{
+  // x * reciprocal(d) against x / d, for divisors spanning the sample_t
+  // range, from phase increments of a few LSB up to 15
+  srand(1);
+  int32_t worst = 0;
+  for (int i = 0; i < 100000; i++)
+  {
+    const int32_t d = 1 + (rand() % (15 << sample_t::shift_)) / ((rand() % 4096) + 1);
+    const sample_t divisor = sample_t::fromValue((i & 1) ? d : -d);
+    const auto r = reciprocal(divisor);
+
+    // Keep the quotient within sample_t
+    const double limit = std::fabs(float(divisor)) * 15.;
+    const double value = std::fmin(limit, 1.) * double(rand() % 2001 - 1000) / 1000.;
+    const sample_t x = sample_t(float(value));
+
+    const int32_t quotient = (x * r).value_;
+    const int32_t expected = (x / divisor).value_;
+    // Both truncate, relative to the size of the result
+    const int32_t error = std::abs(quotient - expected);
+    const int32_t tolerance = 2 + std::abs(expected) / (1 << 22);
+    CHECK(error <= tolerance);
+    if (error > worst)
+      worst = error;
+  }
+  printf("reciprocal: worst error %d LSB\n", worst);
+
+  // Constant divisors fold at compile time
+  static_assert((sample_t(1) * reciprocal(sample_t(4))) == sample_t(0.25), "reciprocal must be constexpr");
+
+  const sample_t divisor = sample_t(0.003f);
+  const auto r = reciprocal(divisor);
+  const double multiply = nanosecondsPerCall(1 << 22, [&](int i) {
+    sink = (sample_t::fromValue(i & 0xfffff) * r).value_;
+  });
+  const double divide = nanosecondsPerCall(1 << 22, [&](int i) {
+    sink = (sample_t::fromValue(i & 0xfffff) / divisor).value_;
+  });
+  printf("reciprocal: multiply %.2f ns, divide %.2f ns\n", multiply, divide);
+
+  return finish("fixed");
+}
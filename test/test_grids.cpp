@@ -0,0 +1,68 @@
+#include "test.h"
+#include "../grids.h"
+
+#include <cstdint>
+
+namespace grids
+{
+  uint8_t ReadDrumMap(uint8_t step, uint8_t instrument, uint8_t x, uint8_t y);
+}
+
+// Keeps the optimizer from dropping the benchmarked work
+static volatile uint32_t sink;
+
+int main()
+{
+  // The cached map holds exactly what the drum map interpolation returns
+  grids::Map map;
+  for (int x = 0; x < 256; x += 7)
+  {
+    for (int y = 0; y < 256; y += 11)
+    {
+      map.update(x, y);
+      CHECK(map.at(x, y));
+      for (uint8_t part = 0; part < grids::kNumParts; part++)
+      {
+        for (uint8_t step = 0; step < grids::kStepsPerPattern; step++)
+        {
+          CHECK(map.level(grids::Selector(part), step) == grids::ReadDrumMap(step, part, x, y));
+        }
+      }
+    }
+  }
+
+  // The kit only sees a new position once update() has swapped it in
+  grids::Kit kit;
+  const uint8_t density[grids::kNumParts] = { 255, 255, 255 };
+  kit.setPosition(0, 0);
+  kit.update();
+  const uint8_t first = kit.process(density, 0);
+  kit.reset();
+  kit.setPosition(200, 200);
+  CHECK(kit.process(density, 0) == first);
+  kit.reset();
+  kit.update();
+  uint8_t expected = 0;
+  for (uint8_t part = 0; part < grids::kNumParts; part++)
+  {
+    const uint8_t level = grids::ReadDrumMap(0, part, 200, 200);
+    if (level > 0)
+    {
+      expected |= 1 << part;
+      if (level > grids::Kit::kAccentThreshold)
+        expected |= 1 << grids::Kit::OUTPUT_ACCENT;
+    }
+  }
+  CHECK(kit.process(density, 0) == expected);
+
+  // A cached step against interpolating the four surrounding nodes
+  const double cached = nanosecondsPerCall(1 << 20, [&](int i) {
+    sink += map.level(grids::Selector(i % grids::kNumParts), i % grids::kStepsPerPattern);
+  });
+  const double interpolated = nanosecondsPerCall(1 << 20, [&](int i) {
+    sink += grids::ReadDrumMap(i % grids::kStepsPerPattern, i % grids::kNumParts, i >> 8, i >> 12);
+  });
+  printf("grids level: cached %.2f ns, interpolated %.2f ns\n", cached, interpolated);
+
+  return finish("grids");
+}
@@ -0,0 +1,56 @@
+#include "test.h"
+#include "src/nostromo/fixed_debug.h"
+#include "src/nostromo/dsp.h"
+#include "src/nostromo/ramped_value.h"
+
+// sample_t with overflow statistics
+typedef FixedFP<int32_t, 27, OverflowCounting> counted_t;
+
+static void rampAcrossRange()
+{
+  OverflowCounting::Site site;
+  RampedValue32<counted_t> ramp;
+  const float targets[] = { 15.9f, -15.9f, 0.f, -15.9f, 15.9f };
+  const uint32_t durations[] = { 2, 3, 127, 1000, 65536 };
+  for (const auto duration: durations)
+  {
+    for (const auto target: targets)
+    {
+      ramp.rampTo(counted_t(target), duration);
+      while (ramp.isRamping())
+      {
+        ramp.tick();
+      }
+      CHECK(ramp.value() == counted_t(target));
+    }
+  }
+}
+
+// 1 + g (g + damping) of StateVariableFilter, if it were done in sample_t
+static void svfDenominator()
+{
+  OverflowCounting::Site site;
+  for (int i = 0; i < filter_tables::kEntries; i++)
+  {
+    const auto g = counted_t::fromValue(filter_tables::kTable.g[i]);
+    const auto denominator = counted_t(1) + g * (g + counted_t(2));
+    (void)denominator;
+  }
+}
+
+int main()
+{
+  rampAcrossRange();
+  svfDenominator();
+  OverflowCounting::report();
+
+  const auto& stats = OverflowCounting::stats();
+  // Ramps accumulate their increment, and still never leave sample_t
+  CHECK(stats.at("rampAcrossRange").operations > 0);
+  CHECK(stats.at("rampAcrossRange").overflows == 0);
+  // Which is why the filter keeps it in 64 bits
+  CHECK(stats.at("svfDenominator").overflows > 0);
+  CHECK(stats.at("svfDenominator").integerBits() > 4);
+
+  return finish("overflow");
+}
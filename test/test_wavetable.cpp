@@ -0,0 +1,49 @@
+#include "test.h"
+#include "src/nostromo/fixed.h"
+#include "src/nostromo/oscillators/wavetable.h"
+
+#include <cmath>
+#include <cstdint>
+
+// Same layout as HS::VOSegment
+struct Segment
+{
+  uint8_t level;
+  uint8_t time;
+};
+
+int main()
+{
+  // The runtime build of a user cycle matches the compile time tables at
+  // every mip level. The vector oscillator's default triangle starts at its
+  // lowest point, i.e. a quarter of a cycle after the basic triangle; its
+  // levels reach -1 - 1/127. A jump is only placed to the nearest sample by
+  // the runtime build, so this takes a continuous shape.
+  const Segment triangle[] = { {0xff, 0x01}, {0x00, 0x01} };
+  Wavetable user;
+  user.buildFromSegments(triangle, 2);
+  const auto& reference = wavetables::get(wavetables::Shapes::Triangle);
+
+  double worst = 0.;
+  const sample_t quarter(0.75);
+  for (double frequency = 20.; frequency < 8000.; frequency *= 1.5)
+  {
+    const auto phaseInc = sample_t(frequency / 16666.);
+    for (int n = 0; n < 1000; n++)
+    {
+      const auto phase = sample_t(n / 1000.);
+      const double expected = double(float(reference.read(phase + quarter, phaseInc)));
+      const double actual = double(float(user.read(phase, phaseInc)));
+      worst = std::fmax(worst, std::fabs(actual - expected));
+    }
+  }
+  printf("user triangle: worst error %g\n", worst);
+  CHECK(worst < 0.02);
+
+  // No time at all is silence, not a division by zero
+  const Segment empty[] = { {0xff, 0x00} };
+  user.buildFromSegments(empty, 1);
+  CHECK(float(user.read(sample_t(0.25), sample_t(0.001))) == 0.f);
+
+  return finish("wavetable");
+}
@@ -0,0 +1,416 @@
+// Copyright (c) 2015 Patrick Dowling
+//
+// Author: Patrick Dowling (pld@gurkenkiste.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef JOURNALSTORAGE_H_
+#define JOURNALSTORAGE_H_
+
+#include "util_misc.h"
+#include "util_pagestorage.h"
+
+/**
+ * Log-structured storage for chunks of data that change independently (e.g.
+ * the settings of each app), identified by a 16-bit id.
+ *
+ * The available space is split into two banks. Saving a chunk appends a
+ * record with a CRC to the active bank, but only if the contents differ from
+ * the latest record with the same id. So a save only costs what has actually
+ * changed, and writes walk through the whole bank instead of hitting the same
+ * locations every time.
+ *
+ * When the free space in the active bank drops below the size of the live
+ * data, the latest record of each chunk is copied to the other bank. This is
+ * done in small steps by calling ::Compact, e.g. from the main loop. The copy
+ * only becomes valid once its bank header with the next epoch is written, so
+ * an interrupted compaction leaves the current bank intact.
+ *
+ * Every compaction attempt uses a new epoch, which is claimed by writing a
+ * pending header to the target bank before any record. Records of an
+ * interrupted or failed attempt can't then pass the check of a later one.
+ *
+ * Record headers include the bank epoch in their check value, which makes
+ * leftovers from previous uses of a bank invalid without having to erase it.
+ *
+ * Note that storage is uninitialized until ::Load or ::Init is called!
+ */
+template <typename STORAGE, size_t BASE_ADDR, size_t END_ADDR, uint32_t FOURCC, size_t MAX_CHUNKS>
+class JournalStorage {
+protected:
+
+  struct bank_header {
+    uint32_t fourcc;
+    uint32_t epoch;
+    uint16_t check;
+    uint16_t flags;
+  } __attribute__((aligned(2)));
+
+  // Bank is being compacted to and its epoch is only claimed
+  static const uint16_t BANK_PENDING = 0x1;
+
+  struct record_header {
+    uint16_t id;
+    uint16_t length;
+    uint16_t crc;
+    uint16_t check;
+  } __attribute__((aligned(2)));
+
+  // In-memory index of the latest record per id
+  struct chunk_index {
+    uint16_t id;
+    uint16_t length;
+    uint16_t crc;
+    uint16_t addr; // data address in active bank
+    uint16_t compacted_addr; // data address in bank being compacted to
+    bool compacted;
+  };
+
+public:
+
+  static const size_t LENGTH = END_ADDR - BASE_ADDR;
+  static const size_t BANKS = 2;
+  static const size_t BANKSIZE = (LENGTH / BANKS) & ~1;
+  static const size_t kCompactBlockSize = 32;
+
+  // throw compiler error if banks are too small
+  typedef bool CHECK_BANKS[BANKSIZE > sizeof(bank_header) + sizeof(record_header) ? 1 : -1];
+  // throw compiler error if OOB
+  typedef bool CHECK_BASEADDR[BASE_ADDR + LENGTH > STORAGE::LENGTH ? -1 : 1];
+
+  /**
+   * @return index of active bank; only valid after ::Load or first ::Write
+   */
+  int bank_index() const {
+    return bank_;
+  }
+
+  /**
+   * @return bytes still available in active bank
+   */
+  size_t available() const {
+    return bank_ < 0 ? BANKSIZE - sizeof(bank_header) : bank_addr(bank_) + BANKSIZE - write_addr_;
+  }
+
+  /**
+   * Use this instead of load to get a valid (empty) state for saving
+   */
+  void Init() {
+    bank_ = -1;
+    epoch_ = 0;
+    last_epoch_ = 0;
+    write_addr_ = 0;
+    num_chunks_ = 0;
+    compact_bank_ = -1;
+  }
+
+  /**
+   * Find the newest bank and build the index of latest records.
+   * @return true if a valid bank was found
+   */
+  bool Load() {
+    Init();
+
+    for (size_t b = 0; b < BANKS; ++b) {
+      bank_header header;
+      STORAGE::read(bank_addr(b), &header, sizeof(header));
+      STORAGE_PRINTF("[%u] FOURCC:%x (%x) epoch:%u flags:%x\n", bank_addr(b), header.fourcc, FOURCC, header.epoch, header.flags);
+      if (FOURCC != header.fourcc || bank_check(header) != header.check)
+        continue;
+      if (static_cast<int32_t>(header.epoch - last_epoch_) > 0)
+        last_epoch_ = header.epoch;
+      if (header.flags & BANK_PENDING)
+        continue;
+      if (bank_ < 0 || static_cast<int32_t>(header.epoch - epoch_) > 0) {
+        bank_ = b;
+        epoch_ = header.epoch;
+      }
+    }
+    if (bank_ < 0)
+      return false;
+
+    const size_t end = bank_addr(bank_) + BANKSIZE;
+    size_t addr = bank_addr(bank_) + sizeof(bank_header);
+    while (addr + sizeof(record_header) <= end) {
+      record_header record;
+      STORAGE::read(addr, &record, sizeof(record));
+      const size_t data_addr = addr + sizeof(record_header);
+      if (record_check(record, epoch_) != record.check || data_addr + record.length > end)
+        break;
+
+      if (record.crc == storage_crc(data_addr, record.length)) {
+        chunk_index *chunk = find_or_add(record.id);
+        if (chunk) {
+          chunk->length = record.length;
+          chunk->crc = record.crc;
+          chunk->addr = data_addr;
+        }
+      } else {
+        STORAGE_PRINTF("Ignoring corrupt record %x @%u\n", record.id, addr);
+      }
+      addr = data_addr + aligned(record.length);
+    }
+    write_addr_ = addr;
+    STORAGE_PRINTF("Loaded bank %d, epoch %u, %u chunks, %u bytes free\n", bank_, epoch_, num_chunks_, available());
+
+    return true;
+  }
+
+  /**
+   * Read latest version of chunk
+   * @return true if chunk exists with the expected length
+   */
+  bool Read(uint16_t id, void *data, size_t length) const {
+    const chunk_index *chunk = find(id);
+    if (!chunk || chunk->length != length)
+      return false;
+    STORAGE::read(chunk->addr, data, length);
+    return true;
+  }
+
+  /**
+   * Append chunk to journal if it differs from the stored version. If the
+   * active bank is full, a pending compaction is finished first (blocking).
+   * @return true if data was written to storage
+   */
+  bool Write(uint16_t id, const void *data, size_t length) {
+    const uint16_t crc = crc16(0xffff, data, length);
+    chunk_index *chunk = find_or_add(id);
+    if (!chunk || (chunk->addr && chunk->length == length && chunk->crc == crc))
+      return false;
+
+    if (bank_ < 0)
+      Format();
+
+    const size_t record_size = sizeof(record_header) + aligned(length);
+    if (available() < record_size) {
+      if (compact_bank_ < 0)
+        BeginCompaction();
+      while (Compact()) { }
+      if (available() < record_size) {
+        STORAGE_PRINTF("Chunk %x (%u bytes) doesn't fit\n", id, length);
+        return false;
+      }
+    }
+
+    chunk->addr = append(write_addr_, epoch_, id, data, length, crc);
+    chunk->length = length;
+    chunk->crc = crc;
+    write_addr_ += record_size;
+
+    // A copy started or made before this write is stale now
+    if (compact_bank_ >= 0) {
+      if (copy_chunk_ == chunk)
+        copy_chunk_ = nullptr;
+      chunk->compacted = false;
+    } else if (available() < live_size()) {
+      BeginCompaction();
+    }
+
+    return true;
+  }
+
+  /**
+   * Do a single step of pending compaction, copying at most kCompactBlockSize
+   * bytes of data.
+   * @return true if there's more work to do
+   */
+  bool Compact() {
+    if (compact_bank_ < 0)
+      return false;
+
+    if (!copy_chunk_) {
+      for (size_t i = 0; i < num_chunks_ && !copy_chunk_; ++i) {
+        if (chunks_[i].addr && !chunks_[i].compacted)
+          copy_chunk_ = &chunks_[i];
+      }
+
+      if (!copy_chunk_) {
+        CommitCompaction();
+        return false;
+      }
+
+      const size_t record_size = sizeof(record_header) + aligned(copy_chunk_->length);
+      if (compact_addr_ + record_size > bank_addr(compact_bank_) + BANKSIZE) {
+        STORAGE_PRINTF("Compaction to bank %d failed, out of space\n", compact_bank_);
+        compact_bank_ = -1;
+        return false;
+      }
+
+      record_header record = { copy_chunk_->id, copy_chunk_->length, copy_chunk_->crc, 0 };
+      record.check = record_check(record, compact_epoch_);
+      write(compact_addr_, &record, sizeof(record));
+      copy_chunk_->compacted_addr = compact_addr_ + sizeof(record_header);
+      copy_offset_ = 0;
+      compact_addr_ += record_size;
+      return true;
+    }
+
+    uint8_t block[kCompactBlockSize];
+    size_t length = copy_chunk_->length - copy_offset_;
+    if (length > kCompactBlockSize)
+      length = kCompactBlockSize;
+    STORAGE::read(copy_chunk_->addr + copy_offset_, block, length);
+    write(copy_chunk_->compacted_addr + copy_offset_, block, length);
+    copy_offset_ += length;
+    if (copy_offset_ >= copy_chunk_->length) {
+      copy_chunk_->compacted = true;
+      copy_chunk_ = nullptr;
+    }
+    return true;
+  }
+
+protected:
+
+  int bank_;
+  uint32_t epoch_;
+  uint32_t last_epoch_; // highest epoch committed or claimed by a compaction
+  size_t write_addr_;
+
+  chunk_index chunks_[MAX_CHUNKS];
+  size_t num_chunks_;
+
+  int compact_bank_;
+  uint32_t compact_epoch_;
+  size_t compact_addr_;
+  chunk_index *copy_chunk_;
+  size_t copy_offset_;
+
+  static size_t bank_addr(size_t bank) {
+    return BASE_ADDR + bank * BANKSIZE;
+  }
+
+  static size_t aligned(size_t length) {
+    return (length + 1) & ~1;
+  }
+
+  static void write(size_t addr, const void *data, size_t length) {
+    STORAGE::update(addr, data, length);
+  }
+
+  void Format() {
+    compact_bank_ = -1;
+    bank_ = 0;
+    epoch_ = ++last_epoch_;
+    write_header(bank_, epoch_, 0);
+    write_addr_ = bank_addr(bank_) + sizeof(bank_header);
+    STORAGE_PRINTF("Formatted bank %d, epoch %u\n", bank_, epoch_);
+  }
+
+  void BeginCompaction() {
+    STORAGE_PRINTF("Begin compaction, %u of %u bytes live\n", live_size(), BANKSIZE);
+    compact_bank_ = (bank_ + 1) % BANKS;
+    compact_epoch_ = ++last_epoch_;
+    write_header(compact_bank_, compact_epoch_, BANK_PENDING);
+    compact_addr_ = bank_addr(compact_bank_) + sizeof(bank_header);
+    copy_chunk_ = nullptr;
+    for (size_t i = 0; i < num_chunks_; ++i)
+      chunks_[i].compacted = false;
+  }
+
+  void CommitCompaction() {
+    write_header(compact_bank_, compact_epoch_, 0);
+    for (size_t i = 0; i < num_chunks_; ++i)
+      chunks_[i].addr = chunks_[i].compacted_addr;
+    bank_ = compact_bank_;
+    epoch_ = compact_epoch_;
+    write_addr_ = compact_addr_;
+    compact_bank_ = -1;
+    STORAGE_PRINTF("Compacted to bank %d, epoch %u, %u bytes free\n", bank_, epoch_, available());
+  }
+
+  static void write_header(size_t bank, uint32_t epoch, uint16_t flags) {
+    bank_header header = { FOURCC, epoch, 0, flags };
+    header.check = bank_check(header);
+    write(bank_addr(bank), &header, sizeof(header));
+  }
+
+  static uint16_t append(size_t addr, uint32_t epoch, uint16_t id, const void *data, size_t length, uint16_t crc) {
+    record_header record = { id, static_cast<uint16_t>(length), crc, 0 };
+    record.check = record_check(record, epoch);
+    write(addr + sizeof(record_header), data, length);
+    write(addr, &record, sizeof(record));
+    return addr + sizeof(record_header);
+  }
+
+  size_t live_size() const {
+    size_t size = 0;
+    for (size_t i = 0; i < num_chunks_; ++i) {
+      if (chunks_[i].addr)
+        size += sizeof(record_header) + aligned(chunks_[i].length);
+    }
+    return size;
+  }
+
+  const chunk_index *find(uint16_t id) const {
+    for (size_t i = 0; i < num_chunks_; ++i) {
+      if (chunks_[i].id == id && chunks_[i].addr)
+        return &chunks_[i];
+    }
+    return nullptr;
+  }
+
+  chunk_index *find_or_add(uint16_t id) {
+    for (size_t i = 0; i < num_chunks_; ++i) {
+      if (chunks_[i].id == id)
+        return &chunks_[i];
+    }
+    if (num_chunks_ >= MAX_CHUNKS)
+      return nullptr;
+
+    chunk_index *chunk = &chunks_[num_chunks_++];
+    memset(chunk, 0, sizeof(chunk_index));
+    chunk->id = id;
+    return chunk;
+  }
+
+  static uint16_t bank_check(const bank_header &header) {
+    return ~((header.fourcc >> 16) ^ header.fourcc ^ (header.epoch >> 16) ^ header.epoch ^ header.flags) & 0xffff;
+  }
+
+  static uint16_t record_check(const record_header &record, uint32_t epoch) {
+    return ~(record.id ^ record.length ^ record.crc ^ (epoch >> 16) ^ epoch) & 0xffff;
+  }
+
+  // CRC-16-CCITT
+  static uint16_t crc16(uint16_t crc, const void *data, size_t length) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (length--) {
+      crc ^= static_cast<uint16_t>(*p++) << 8;
+      for (int i = 0; i < 8; ++i)
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+    return crc;
+  }
+
+  static uint16_t storage_crc(size_t addr, size_t length) {
+    uint16_t crc = 0xffff;
+    uint8_t block[kCompactBlockSize];
+    while (length) {
+      const size_t n = length > kCompactBlockSize ? kCompactBlockSize : length;
+      STORAGE::read(addr, block, n);
+      crc = crc16(crc, block, n);
+      addr += n;
+      length -= n;
+    }
+    return crc;
+  }
+};
+
+#endif // JOURNALSTORAGE_H_